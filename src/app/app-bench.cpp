@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "arguments.h"
+#include "mandelbrot.h"
+#include "color/color-strategy-smooth.h"
+#include "kernel/precise-real.h"
+#include "output/output-device-null.h"
+
+using namespace mandelbrot;
+using namespace std;
+
+/// View of the plane that is rendered by the benchmark
+struct Scene
+{
+    const char *name;
+
+    /// Center of the scene, with every digit that deep scenes need to stay on the boundary of the set
+    const char *centerX;
+    const char *centerY;
+    double scale;
+    int maxIterations;
+};
+
+/// Catalogue of scenes. The scale of each is given for a frame 1024 pixels wide, and adjusted to the width of the benchmark.
+/// The deep scenes are centered on Misiurewicz points, around which the boundary has detail at every scale
+static const Scene Scenes[] = {
+    { "default", "-0.637011", "-0.0395159", 0.00403897, 400 },
+    { "seahorse-valley", "-0.743643887", "0.131825904", 2e-6, 2000 },
+    { "interior", "-0.5", "0.0", 0.0035, 5000 },
+    { "deep-1e-20",
+      "-0.228155493653961819214572014099126006737398351174508032379597981084415663036013066757421042711970437268939585386816469905",
+      "1.115142508039937359745764636315014068188778090467954603627468033481040909294635516857257200687476522887210032245103332467",
+      1e-20, 3000 },
+    { "deep-1e-100",
+      "-1.430357632451307398974930072390250390342155614723808289124506346826715483920193819310422456838722443990015436271903353709",
+      "0.0",
+      1e-100, 3000 }
+};
+
+/// Timings of a scene rendered with a given number of threads
+struct Run
+{
+    int numThreads;
+    std::vector<double> frameSeconds;
+    double medianSeconds;
+
+    /// Iteration counts of the pixels added up, including the iterations skipped to arrive at them
+    uint64_t logicalIterations;
+    uint64_t seriesSkippedIterations;
+    uint64_t interiorSkippedIterations;
+
+    /// Set if every pixel of the last frame took the same number of iterations, which leaves nothing to measure
+    bool uniform;
+
+    /// Instrumentation of the last frame
+    RenderStats stats;
+};
+
+/// Renders a scene the given number of times, each time with a new set, so that no frame benefits from the one before it
+static Run runScene(const Scene &scene, int width, int height, int numThreads, int repetitions)
+{
+    Run run { numThreads, {}, 0.0, 0, 0, 0, false, {} };
+
+    for (int i = 0; i < repetitions; ++i)
+    {
+        MandelbrotSet mbSet(numThreads);
+        mbSet.setMaxIterations(scene.maxIterations);
+        mbSet.setColorStrategy(std::make_unique<ColorStrategySmooth>());
+        mbSet.setOutputDevice(std::make_unique<OutputDeviceNull>());
+        mbSet.setOutputDimensions(width, height);
+        mbSet.setScale(scene.scale * 1024.0 / width);
+        mbSet.setCenter(PreciseReal::fromString(scene.centerX), PreciseReal::fromString(scene.centerY));
+        mbSet.setStatsEnabled(true);
+        mbSet.setTileStatsEnabled(false);
+
+        const auto start = std::chrono::steady_clock::now();
+        mbSet.render();
+        const auto end = std::chrono::steady_clock::now();
+        run.frameSeconds.push_back(std::chrono::duration<double>(end - start).count());
+
+        // Every pixel counts the iterations it took, including those skipped by the series approximation or
+        // by recognizing it as part of the set early
+        const IterationBuffer &buffer = mbSet.getIterationBuffer();
+        const int *iterations = buffer.getIterations();
+        const size_t numPixels = static_cast<size_t>(buffer.getWidth()) * buffer.getHeight();
+        uint64_t total = 0;
+        for (size_t p = 0; p < numPixels; ++p)
+            total += static_cast<uint64_t>(iterations[p]);
+        run.logicalIterations = total;
+        run.uniform = std::all_of(iterations, iterations + numPixels, [iterations](int n) { return n == iterations[0]; });
+        run.seriesSkippedIterations = mbSet.getSeriesSkippedIterations();
+        run.interiorSkippedIterations = mbSet.getInteriorSkippedIterations();
+        run.stats = mbSet.getRenderStats();
+    }
+
+    std::vector<double> sorted = run.frameSeconds;
+    std::sort(sorted.begin(), sorted.end());
+    run.medianSeconds = sorted[sorted.size() / 2];
+    return run;
+}
+
+int main(int argc, char **argv)
+{
+    std::string widthStr, heightStr, repetitionsStr, threadsStr, sceneStr, outputStr;
+
+    std::vector<Argument> argTable {
+        { R"(x)", R"(width)", R"(Width of each frame)", R"(640)", &widthStr },
+        { R"(y)", R"(height)", R"(Height of each frame)", R"(480)", &heightStr },
+        { R"(r)", R"(repetitions)", R"(Number of frames rendered per scene and thread count)", R"(3)", &repetitionsStr },
+        { R"(t)", R"(threads)", R"(Largest number of threads measured, after every power of two below it)", std::to_string(std::max(1u, std::thread::hardware_concurrency())), &threadsStr },
+        { R"(s)", R"(scene)", R"(Name of the scene to measure, or all)", R"(all)", &sceneStr },
+        { R"(o)", R"(output)", R"(File to write the JSON report to, or - for the console)", R"(-)", &outputStr }
+    };
+
+    parseArgs("Mandelbrot Benchmark", argc, argv, argTable);
+    if (argTable.empty())
+        return 0;
+
+    const int width = std::stoi(widthStr), height = std::stoi(heightStr);
+    const int repetitions = std::max(1, std::stoi(repetitionsStr));
+    const int maxThreads = std::max(1, std::stoi(threadsStr));
+
+    std::vector<int> threadCounts;
+    for (int n = 1; n < maxThreads; n *= 2)
+        threadCounts.push_back(n);
+    threadCounts.push_back(maxThreads);
+
+    const double numPixels = static_cast<double>(width) * height;
+
+    std::ostringstream json;
+    json << std::setprecision(6);
+    json << "{\n"
+         << "  \"width\": " << width << ",\n"
+         << "  \"height\": " << height << ",\n"
+         << "  \"repetitions\": " << repetitions << ",\n"
+         << "  \"scenes\": [";
+
+    bool firstScene = true;
+    bool failed = false;
+    for (const Scene &scene : Scenes)
+    {
+        if (sceneStr.compare(R"(all)") != 0 && sceneStr.compare(scene.name) != 0)
+            continue;
+
+        json << (firstScene ? "\n" : ",\n")
+             << "    {\n"
+             << "      \"name\": \"" << scene.name << "\",\n"
+             << "      \"centerX\": \"" << scene.centerX << "\",\n"
+             << "      \"centerY\": \"" << scene.centerY << "\",\n"
+             << "      \"scale\": " << scene.scale * 1024.0 / width << ",\n"
+             << "      \"maxIterations\": " << scene.maxIterations << ",\n"
+             << "      \"runs\": [";
+        firstScene = false;
+
+        double singleThreadSeconds = 0.0;
+        for (size_t i = 0; i < threadCounts.size(); ++i)
+        {
+            cerr << scene.name << ": " << threadCounts[i] << " thread(s)" << endl;
+
+            const Run run = runScene(scene, width, height, threadCounts[i], repetitions);
+            if (i == 0)
+                singleThreadSeconds = run.medianSeconds;
+
+            // A frame of a single color says nothing about the speed of the render path it was meant to measure
+            if (run.uniform)
+            {
+                cerr << scene.name << ": every pixel took " << run.logicalIterations / numPixels << " iterations" << endl;
+                failed = true;
+            }
+
+            json << (i == 0 ? "\n" : ",\n")
+                 << "        {\n"
+                 << "          \"threads\": " << run.numThreads << ",\n"
+                 << "          \"frameSeconds\": [";
+            for (size_t f = 0; f < run.frameSeconds.size(); ++f)
+                json << (f == 0 ? "" : ", ") << run.frameSeconds[f];
+            // Share of the time of the threads spent waiting for work, which grows as the tiles run out
+            double busySeconds = 0.0, idleSeconds = 0.0;
+            for (const ThreadStats &thread : run.stats.threads)
+            {
+                busySeconds += thread.busySeconds;
+                idleSeconds += thread.idleSeconds;
+            }
+            const double idleFraction = busySeconds + idleSeconds > 0.0 ? idleSeconds / (busySeconds + idleSeconds) : 0.0;
+
+            json << "],\n"
+                 << "          \"medianFrameSeconds\": " << run.medianSeconds << ",\n"
+                 << "          \"pixelsPerSecond\": " << numPixels / run.medianSeconds << ",\n"
+                 << "          \"iterations\": " << run.stats.iterations << ",\n"
+                 << "          \"iterationsPerSecond\": " << static_cast<double>(run.stats.iterations) / run.medianSeconds << ",\n"
+                 << "          \"logicalIterations\": " << run.logicalIterations << ",\n"
+                 << "          \"seriesSkippedIterations\": " << run.seriesSkippedIterations << ",\n"
+                 << "          \"interiorSkippedIterations\": " << run.interiorSkippedIterations << ",\n"
+                 << "          \"uniform\": " << (run.uniform ? "true" : "false") << ",\n"
+                 << "          \"referenceSeconds\": " << run.stats.referenceSeconds << ",\n"
+                 << "          \"iterateSeconds\": " << run.stats.iterateSeconds << ",\n"
+                 << "          \"colorSeconds\": " << run.stats.colorSeconds << ",\n"
+                 << "          \"histogramSeconds\": " << run.stats.histogramSeconds << ",\n"
+                 << "          \"flushSeconds\": " << run.stats.flushSeconds << ",\n"
+                 << "          \"idleFraction\": " << idleFraction << ",\n"
+                 << "          \"speedup\": " << singleThreadSeconds / run.medianSeconds << "\n"
+                 << "        }";
+        }
+
+        json << "\n      ]\n    }";
+    }
+
+    json << "\n  ]\n}\n";
+
+    if (outputStr.compare(R"(-)") == 0)
+    {
+        cout << json.str();
+    }
+    else
+    {
+        std::ofstream out { outputStr };
+        if (!out.is_open())
+        {
+            cerr << "Could not open " << outputStr << endl;
+            return 1;
+        }
+        out << json.str();
+    }
+
+    return failed ? 1 : 0;
+}
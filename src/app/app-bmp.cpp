@@ -5,167 +5,231 @@
 #include <string>
 #include <vector>
 
+#include "arguments.h"
 #include "mandelbrot.h"
+#include "color/color-strategy-gradient.h"
+#include "color/color-strategy-histogram.h"
 #include "color/color-strategy-iteration.h"
 #include "color/color-strategy-smooth.h"
 #include "color/color-strategy-wavelength.h"
 #include "output/output-device-bmp.h"
+#include "output/output-device-png.h"
+#include "tile-pyramid.h"
+#include "zoom-sequence.h"
 
 using namespace mandelbrot;
 using namespace std;
 
-struct Argument
+/// Prints the instrumentation of a frame, followed by the time taken by each of its tiles if requested
+static void printStats(const RenderStats &stats, bool printTiles)
 {
-    std::string shortName;
-    std::string longName;
-    std::string description;
-    std::string defaultValue;
-    std::string *value;
-};
-
-void printHelp(const std::string &appName, const std::vector<Argument> &argTable)
-{
-    cout << "Mandelbrot Image Generator" << endl;
-    cout << "Usage: " << appName << " [arguments]" << endl << endl;
-    
-    cout << "Arguments:" << endl;
-    
-    const int spaceToDescription = 28;
-    for (const Argument &arg : argTable)
+    static const char *pathNames[] = { "direct", "perturbation", "precise" };
+    static const char *precisionNames[] = { "float", "double", "double-double", "mpfr" };
+
+    cout << "Path: " << pathNames[static_cast<int>(stats.path)] << (stats.cancelled ? " (cancelled)" : "") << endl
+         << "Precision: " << precisionNames[static_cast<int>(stats.precision)];
+    if (stats.mpfrPrecision > 0)
+        cout << " (mpfr " << stats.mpfrPrecision << " bits)";
+    cout << endl
+         << "Bands: " << stats.numBands << endl
+         << "Iterations: " << stats.iterations << " (skipped: " << stats.seriesSkippedIterations << " series, "
+         << stats.interiorSkippedIterations << " interior)" << endl
+         << "Pixels: " << stats.escapedPixels << " escaped, " << stats.inSetPixels << " in set, "
+         << stats.supersampledPixels << " supersampled" << endl
+         << "Time: " << stats.totalSeconds << " s (reference " << stats.referenceSeconds << ", iterate " << stats.iterateSeconds
+         << ", color " << stats.colorSeconds << ", histogram " << stats.histogramSeconds << ", output " << stats.outputSeconds << ", flush " << stats.flushSeconds << ")" << endl;
+
+    for (size_t i = 0; i < stats.threads.size(); ++i)
     {
-        int spacesTaken = static_cast<int>(arg.shortName.size()) + 3;
-        
-        cout << " -" << arg.shortName;
-        if (!arg.longName.empty())
-        {
-            cout << ",  --" << arg.longName << "=VALUE";
-            spacesTaken += 11 + static_cast<int>(arg.longName.size());
-        }
-        
-        if (spaceToDescription - spacesTaken > 0)
-        {
-            std::string spaceBuffer(spaceToDescription - spacesTaken, ' ');
-            cout << spaceBuffer;
-        }
-        cout << " " << arg.description << endl;
-        
-        std::string spaceBuffer(spaceToDescription, ' ');
-        cout << spaceBuffer << "Default: " << arg.defaultValue << endl << endl;
+        const ThreadStats &thread = stats.threads[i];
+        cout << "Thread " << i << ": " << thread.tiles << " tiles, " << thread.iterations << " iterations, "
+             << thread.busySeconds << " s busy, " << thread.idleSeconds << " s idle" << endl;
     }
-    cout << " -h, --help                 Display this help message." << endl << endl;
-}
-
-std::vector<Argument> &parseArgs(int argc, char **argv, std::vector<Argument> &argTable)
-{
-    const std::string shortHelpFlag = R"(-h)",
-                      longHelpFlag = R"(--help)";
-    for (int i = 1; i < argc; ++i)
-    {
-        std::string argN = argv[i];
-        
-        if (argN.size() <= 1 || argN[0] != '-')
-            continue;
-        
-        // Check if we need to print the help table and exit the program
-        if (argN.compare(shortHelpFlag) == 0 || argN.compare(longHelpFlag) == 0)
-        {
-            std::string appName = argv[0];
-            auto appDelimPos = appName.find_last_of('/');
-            if (appDelimPos != std::string::npos)
-                appName = appName.substr(appDelimPos + 1);
-            
-            printHelp(appName, argTable);
-            argTable.clear();
-            return argTable;
-        }
-
-        auto it = std::find_if(argTable.begin(), argTable.end(), [&argN](const Argument &arg) {
-            return (argN.compare(1, argN.size() - 1, arg.shortName) == 0
-                    || argN.compare(2, std::min(argN.size() - 2, arg.longName.size()), arg.longName) == 0);
-        });
-
-        if (it == argTable.end())
-            continue;
-
-        std::string argValue;
-        auto delimPos = argN.find('=');
-        if (delimPos != std::string::npos)
-        {
-            argValue = argN.substr(delimPos + 1);
-        }
-        else if (i + 1 < argc)
-        {
-            argValue = argv[i + 1];
-            i++;
-        }
 
-        std::string *valuePtr = it->value;
-        if (valuePtr != nullptr)
-            *valuePtr = argValue.empty() ? it->defaultValue : argValue;
-    }
+    if (!printTiles)
+        return;
 
-    for (Argument &arg : argTable)
+    for (const TileStats &tile : stats.tiles)
     {
-        if (arg.value && arg.value->empty())
-            *(arg.value) = arg.defaultValue;
+        cout << "Tile " << tile.tile.x << "," << tile.tile.y << " " << tile.tile.width << "x" << tile.tile.height
+             << (tile.phase == RenderPhase::Iterate ? " iterate" : " color") << " pass " << tile.spacing
+             << " thread " << tile.thread << ": " << tile.seconds << " s, " << tile.iterations << " iterations" << endl;
     }
-
-    return argTable;
 }
 
 int main(int argc, char **argv)
 {
-    std::string fileName, cXStr, cYStr, scaleStr, widthStr, heightStr, iterStr, colorStr;
+    std::string fileName, cXStr, cYStr, scaleStr, widthStr, heightStr, iterStr, colorStr, strategyStr, bandStr, compressionStr, pyramidDir, levelsStr, framesStr, endScaleStr, keyframeStr, statsStr, precisionStr, deepStr, gradientStr, periodStr, samplesStr, colorThresholdStr, iterThresholdStr;
 
     std::vector<Argument> argTable {
-        { R"(f)", R"(filename)", R"(Name of the output file)", R"(mandelbrot.bmp)", &fileName },
-        { R"(cx)", R"(centerX)", R"(Center x coordinate on the plane)", R"(-0.637011)", &cXStr },
-        { R"(cy)", R"(centerY)", R"(Center y coordinate on the plane)", R"(-0.0395159)", &cYStr },
-        { R"(s)", R"(scale)", R"(Magnification level of the fractal plane)", R"(0.00403897)", &scaleStr },
+        { R"(f)", R"(filename)", R"(Name of the output file, ending in .bmp or .png)", R"(mandelbrot.bmp)", &fileName },
+        { R"(cx)", R"(centerX)", R"(Center x coordinate on the plane, with every digit kept)", R"(-0.637011)", &cXStr },
+        { R"(cy)", R"(centerY)", R"(Center y coordinate on the plane, with every digit kept)", R"(-0.0395159)", &cYStr },
+        { R"(s)", R"(scale)", R"(Magnification level of the fractal plane, which may be as small as 1e-1000 and beyond)", R"(0.00403897)", &scaleStr },
         { R"(x)", R"(width)", R"(Width of the BMP file)", R"(1024)", &widthStr },
         { R"(y)", R"(height)", R"(Height of the BMP file)", R"(768)", &heightStr },
         { R"(i)", R"(iterations)", R"(Maximum number of iterations per calculation)", R"(400)", &iterStr },
-        { R"(c)", R"(color)", R"(Color strategy. Valid values: smooth, iter, wave)", R"(smooth)", &colorStr}
+        { R"(c)", R"(color)", R"(Color strategy. Valid values: smooth, iter, wave, gradient, histogram)", R"(smooth)", &colorStr},
+        { R"(g)", R"(gradient)", R"(Palette of the gradient and histogram color strategies: a gradient file, or one of classic, fire, ice, grayscale)", R"(classic)", &gradientStr},
+        { R"(gp)", R"(gradientPeriod)", R"(Iterations over which the gradient color strategy runs through its palette once)", R"(64)", &periodStr},
+        { R"(a)", R"(samples)", R"(Samples taken of each pixel along an edge of the image, or 1 for a single sample of every pixel)", R"(1)", &samplesStr},
+        { R"(at)", R"(colorThreshold)", R"(Largest difference in a color channel between neighbouring pixels that is not an edge, or -1 to ignore colors)", R"(16)", &colorThresholdStr},
+        { R"(ai)", R"(iterThreshold)", R"(Largest difference in iterations between neighbouring pixels that is not an edge, or -1 to ignore iterations)", R"(-1)", &iterThresholdStr},
+        { R"(r)", R"(render)", R"(Render strategy. Valid values: exhaustive, subdivide)", R"(exhaustive)", &strategyStr},
+        { R"(b)", R"(band)", R"(Rows rendered and written to the file at a time, or 0 for all)", R"(512)", &bandStr},
+        { R"(z)", R"(compression)", R"(PNG compression. Valid values: default, fast)", R"(default)", &compressionStr},
+        { R"(p)", R"(pyramid)", R"(Directory to write a pyramid of map tiles to, instead of a single image)", R"(none)", &pyramidDir},
+        { R"(l)", R"(levels)", R"(Deepest level of the tile pyramid. Level 0 is rendered at the given scale)", R"(4)", &levelsStr},
+        { R"(n)", R"(frames)", R"(Number of frames of a zoom sequence from the given scale to the end scale, or 0 for one image)", R"(0)", &framesStr},
+        { R"(e)", R"(endScale)", R"(Scale of the last frame of a zoom sequence)", R"(1e-10)", &endScaleStr},
+        { R"(k)", R"(keyframe)", R"(Size of the keyframes of a zoom sequence relative to a frame, or 1 to render every frame)", R"(1)", &keyframeStr},
+        { R"(t)", R"(stats)", R"(Render statistics printed after a single image. Valid values: off, summary, tiles)", R"(off)", &statsStr},
+        { R"(m)", R"(precision)", R"(Least precise arithmetic to iterate in. Valid values: float, double, doubledouble, mpfr)", R"(double)", &precisionStr},
+        { R"(d)", R"(deep)", R"(Deep zoom mode. Valid values: perturbation, precise)", R"(perturbation)", &deepStr}
     };
 
-    parseArgs(argc, argv, argTable);
+    parseArgs("Mandelbrot Image Generator", argc, argv, argTable);
     
     // Table is cleared if user passes help flag, so we only want to print the help message
     // and abort
     if (argTable.empty())
         return 0;
 
-    double cX = std::stod(cXStr); 
-    double cY = std::stod(cYStr);
-    double scale = std::stod(scaleStr);
+    // Coordinates keep every digit they are given, and the scale may go beyond the range of a double
+    const PreciseReal cX = PreciseReal::fromString(cXStr);
+    const PreciseReal cY = PreciseReal::fromString(cYStr);
+    const FloatExp scale = FloatExp::fromString(scaleStr);
 
     int maxIter = std::stoi(iterStr);
     int width = std::stoi(widthStr), height = std::stoi(heightStr);
+    int bandHeight = std::stoi(bandStr);
     
-    if (fileName.find(R"(.bmp)") == std::string::npos)
-        fileName.append(R"(.bmp)");
+    std::unique_ptr<ColorStrategy> colorStrategy;
 
-    std::unique_ptr<OutputDeviceBMP> bmp = std::make_unique<OutputDeviceBMP>();
-    bmp->setFileName(fileName);
-    bmp->setDimensions(int32_t{width}, int32_t{height});
+    auto loadPalette = [&gradientStr]() {
+        const std::vector<std::string> names = Palette::getNames();
+        const bool named = std::find(names.begin(), names.end(), gradientStr) != names.end();
+        return named ? Palette::fromName(gradientStr) : Palette::fromFile(gradientStr);
+    };
 
-    std::unique_ptr<ColorStrategy> colorStrategy;
+    const double period = std::stod(periodStr);
+
+    // Palettes come from files, which may be missing or malformed, or from names, which may be misspelled
+    try
+    {
+        if (colorStr.compare(R"(smooth)") == 0)
+            colorStrategy = std::make_unique<ColorStrategySmooth>();
+        else if (colorStr.compare(R"(iter)") == 0)
+            colorStrategy = std::make_unique<ColorStrategyIteration>();
+        else if (colorStr.compare(R"(wave)") == 0)
+            colorStrategy = std::make_unique<ColorStrategyWavelength>();
+        else if (colorStr.compare(R"(gradient)") == 0)
+        {
+            auto gradientStrategy = std::make_unique<ColorStrategyGradient>(loadPalette());
+            gradientStrategy->setPeriod(period);
+            colorStrategy = std::move(gradientStrategy);
+        }
+        else if (colorStr.compare(R"(histogram)") == 0)
+            colorStrategy = std::make_unique<ColorStrategyHistogram>(loadPalette());
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Cannot load the palette \"" << gradientStr << "\": " << e.what() << std::endl;
+        return 1;
+    }
 
-    if (colorStr.compare(R"(smooth)") == 0)
-        colorStrategy = std::make_unique<ColorStrategySmooth>();
-    else if (colorStr.compare(R"(iter)") == 0)
-        colorStrategy = std::make_unique<ColorStrategyIteration>();
-    else if (colorStr.compare(R"(wave)") == 0)
-        colorStrategy = std::make_unique<ColorStrategyWavelength>();
+    if (!colorStrategy)
+    {
+        std::cerr << "Unknown color strategy: " << colorStr << std::endl;
+        return 1;
+    }
 
     MandelbrotSet mbSet; 
     mbSet.setMaxIterations(maxIter);
-    mbSet.setOutputDevice(std::move(bmp));
+    mbSet.setColorStrategy(std::move(colorStrategy));
+    if (strategyStr.compare(R"(subdivide)") == 0)
+        mbSet.setRenderStrategy(RenderStrategy::MarianiSilver);
+    if (deepStr.compare(R"(precise)") == 0)
+        mbSet.setDeepZoomMode(DeepZoomMode::Precise);
+    mbSet.setSupersampling(std::stoi(samplesStr), std::stoi(colorThresholdStr), std::stoi(iterThresholdStr));
+
+    if (precisionStr.compare(R"(float)") == 0)
+        mbSet.setMinimumPrecision(Precision::Float);
+    else if (precisionStr.compare(R"(doubledouble)") == 0)
+        mbSet.setMinimumPrecision(Precision::DoubleDouble);
+    else if (precisionStr.compare(R"(mpfr)") == 0)
+        mbSet.setMinimumPrecision(Precision::Multi);
+
+    // Every tile of the pyramid is rendered by the same set, and its thread pool
+    if (pyramidDir.compare(R"(none)") != 0)
+    {
+        TilePyramid pyramid(mbSet);
+        pyramid.setDirectory(pyramidDir);
+        pyramid.setRegion(cX, cY, scale);
+        pyramid.setMaxLevel(std::stoi(levelsStr));
+        pyramid.setFastCompression(compressionStr.compare(R"(fast)") == 0);
+
+        const int numTiles = pyramid.generate([](int level, int x, int y) {
+            cout << level << "/" << x << "/" << y << endl;
+        });
+        cout << "Wrote " << numTiles << " tiles" << endl;
+        return 0;
+    }
+
+    const bool png = fileName.size() >= 4 && fileName.compare(fileName.size() - 4, 4, R"(.png)") == 0;
+    if (!png && fileName.find(R"(.bmp)") == std::string::npos)
+        fileName.append(R"(.bmp)");
+
+    // Frames of the sequence are written while the next ones are rendered, and share a reference orbit
+    const int numFrames = std::stoi(framesStr);
+    if (numFrames > 0)
+    {
+        ZoomSequence sequence(mbSet);
+        sequence.setFileName(fileName);
+        sequence.setCenter(cX, cY);
+        sequence.setScales(scale, FloatExp::fromString(endScaleStr));
+        sequence.setFrameCount(numFrames);
+        sequence.setFrameDimensions(width, height);
+        sequence.setKeyframeFactor(std::stod(keyframeStr));
+        sequence.setFastCompression(compressionStr.compare(R"(fast)") == 0);
+
+        const int numRendered = sequence.render([](int frame) {
+            cout << "Frame " << frame << endl;
+        });
+        cout << "Rendered " << numRendered << " images for " << numFrames << " frames" << endl;
+        return 0;
+    }
+
+    // Only a band of rows is held in memory at a time, so that the size of the image is limited by the disk.
+    // PNG files are encoded in the background while the next band is rendered.
+    std::unique_ptr<OutputDevice> outputDevice;
+    if (png)
+    {
+        std::unique_ptr<OutputDevicePNG> pngDevice = std::make_unique<OutputDevicePNG>();
+        pngDevice->setFileName(fileName);
+        pngDevice->setFastCompression(compressionStr.compare(R"(fast)") == 0);
+        outputDevice = std::move(pngDevice);
+    }
+    else
+    {
+        std::unique_ptr<OutputDeviceBMP> bmp = std::make_unique<OutputDeviceBMP>();
+        bmp->setFileName(fileName);
+        bmp->setStreaming(bandHeight > 0);
+        outputDevice = std::move(bmp);
+    }
+    outputDevice->setDimensions(int32_t{width}, int32_t{height});
+
+    mbSet.setOutputDevice(std::move(outputDevice));
     mbSet.setOutputDimensions(width, height);
+    mbSet.setBandHeight(bandHeight);
     mbSet.setScale(scale);
     mbSet.setCenter(cX, cY);
-    mbSet.setColorStrategy(std::move(colorStrategy));
+    mbSet.setStatsEnabled(statsStr.compare(R"(off)") != 0);
+    mbSet.setTileStatsEnabled(statsStr.compare(R"(tiles)") == 0);
     mbSet.render();
 
+    if (statsStr.compare(R"(off)") != 0)
+        printStats(mbSet.getRenderStats(), statsStr.compare(R"(tiles)") == 0);
+
     return 0;
 }
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "arguments.h"
+#include "color/color-strategy-smooth.h"
+
+using namespace mandelbrot;
+using namespace std;
+
+/// Number of pixels colored by each call to getColors(), about the width of a tile
+static constexpr int RunLength = 64;
+
+/// Relative change of modZ on either side of a pixel, well beyond the rounding of the logarithms of the kernel
+static constexpr double Nudge = 1e-4;
+
+/// Largest difference between the channels of two colors
+static int channelDistance(color_t a, color_t b)
+{
+    return std::max({ std::abs(a.argb.r - b.argb.r), std::abs(a.argb.g - b.argb.g),
+                      std::abs(a.argb.b - b.argb.b), std::abs(a.argb.a - b.argb.a) });
+}
+
+/// Returns true if the scalar strategy jumps from one color to another close to the given pixel, which happens
+/// where the saturation wraps around from 1 to 0. The vectorized kernel may come out on either side of it
+static bool isAtWrap(ColorStrategySmooth &strategy, double modZ, double modDz, int iterations, int maxIterations)
+{
+    const color_t below = strategy.getColor(modZ * (1.0 - Nudge), modDz, iterations, maxIterations);
+    const color_t above = strategy.getColor(modZ * (1.0 + Nudge), modDz, iterations, maxIterations);
+    return channelDistance(below, above) > 1;
+}
+
+int main(int argc, char **argv)
+{
+    std::string samplesStr, seedStr, iterStr;
+
+    std::vector<Argument> argTable {
+        { R"(n)", R"(samples)", R"(Number of random pixels colored)", R"(10000000)", &samplesStr },
+        { R"(s)", R"(seed)", R"(Seed of the random inputs)", R"(1)", &seedStr },
+        { R"(i)", R"(iterations)", R"(Maximum number of iterations)", R"(5000)", &iterStr }
+    };
+
+    parseArgs("Mandelbrot Smooth Color Check", argc, argv, argTable);
+    if (argTable.empty())
+        return 0;
+
+    const int numRuns = std::max(1, std::stoi(samplesStr) / RunLength);
+    const int maxIterations = std::max(1, std::stoi(iterStr));
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma"))
+#endif
+    {
+        std::cout << "The processor does not support AVX2 and FMA, so there is no vectorized kernel to check" << std::endl;
+        return 0;
+    }
+
+    std::mt19937 random(static_cast<unsigned>(std::stoul(seedStr)));
+
+    // Escaped points are past |z| = 2, and no further than |z|^2 + |c| from the origin. The derivative, relative
+    // to the size of a pixel, spans the distance estimates of pixels far from the set to those right next to it
+    std::uniform_real_distribution<float> modZDistribution(2.0f, 8.0f);
+    std::uniform_real_distribution<float> logModDzDistribution(-12.0f, 12.0f);
+    std::uniform_int_distribution<int> iterationDistribution(1, maxIterations);
+    std::uniform_int_distribution<int> percentDistribution(0, 99);
+
+    std::vector<float> modZ(RunLength), modDz(RunLength);
+    std::vector<int> iterations(RunLength);
+    std::vector<color_t> colors(RunLength);
+
+    uint64_t numPixels = 0, numDiffering = 0, numWrapped = 0, numFailed = 0;
+    int maxDistance = 0;
+    for (double intensity : { -0.1275, 0.1275 })
+    {
+        ColorStrategySmooth strategy;
+        strategy.setColorIntensity(intensity);
+
+        for (int run = 0; run < numRuns; ++run)
+        {
+            // A few pixels of each run are in the set, or have no derivative
+            for (int i = 0; i < RunLength; ++i)
+            {
+                const int percent = percentDistribution(random);
+                modZ[i] = modZDistribution(random);
+                modDz[i] = percent < 2 ? 0.0f : std::pow(10.0f, logModDzDistribution(random));
+                iterations[i] = percent >= 97 ? maxIterations : iterationDistribution(random);
+            }
+
+            strategy.getColors(modZ.data(), modDz.data(), iterations.data(), RunLength, maxIterations, colors.data());
+
+            for (int i = 0; i < RunLength; ++i)
+            {
+                const color_t expected = iterations[i] >= maxIterations
+                                       ? strategy.getColorInSet()
+                                       : strategy.getColor(modZ[i], modDz[i], iterations[i], maxIterations);
+                const int distance = channelDistance(expected, colors[i]);
+                ++numPixels;
+                if (distance == 0)
+                    continue;
+
+                ++numDiffering;
+                maxDistance = std::max(maxDistance, distance);
+                if (distance > 1 && isAtWrap(strategy, modZ[i], modDz[i], iterations[i], maxIterations))
+                {
+                    ++numWrapped;
+                }
+                else if (distance > 1)
+                {
+                    ++numFailed;
+                    if (numFailed <= 10)
+                    {
+                        std::cerr << "modZ " << modZ[i] << ", modDz " << modDz[i] << ", iterations " << iterations[i]
+                                  << ", intensity " << intensity << ": expected " << std::hex << expected.raw
+                                  << ", got " << colors[i].raw << std::dec << std::endl;
+                    }
+                }
+            }
+        }
+    }
+
+    std::cout << "Pixels: " << numPixels << std::endl;
+    std::cout << "Differing: " << numDiffering << " (largest difference " << maxDistance << ")" << std::endl;
+    std::cout << "At the saturation wrap: " << numWrapped << std::endl;
+    std::cout << "Beyond one per channel: " << numFailed << std::endl;
+    return numFailed == 0 ? 0 : 1;
+}
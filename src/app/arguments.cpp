@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <iostream>
+
+#include "arguments.h"
+
+using namespace std;
+
+void printHelp(const std::string &title, const std::string &appName, const std::vector<Argument> &argTable)
+{
+    cout << title << endl;
+    cout << "Usage: " << appName << " [arguments]" << endl << endl;
+    
+    cout << "Arguments:" << endl;
+    
+    const int spaceToDescription = 28;
+    for (const Argument &arg : argTable)
+    {
+        int spacesTaken = static_cast<int>(arg.shortName.size()) + 3;
+        
+        cout << " -" << arg.shortName;
+        if (!arg.longName.empty())
+        {
+            cout << ",  --" << arg.longName << "=VALUE";
+            spacesTaken += 11 + static_cast<int>(arg.longName.size());
+        }
+        
+        if (spaceToDescription - spacesTaken > 0)
+        {
+            std::string spaceBuffer(spaceToDescription - spacesTaken, ' ');
+            cout << spaceBuffer;
+        }
+        cout << " " << arg.description << endl;
+        
+        std::string spaceBuffer(spaceToDescription, ' ');
+        cout << spaceBuffer << "Default: " << arg.defaultValue << endl << endl;
+    }
+    cout << " -h, --help                 Display this help message." << endl << endl;
+}
+
+std::vector<Argument> &parseArgs(const std::string &title, int argc, char **argv, std::vector<Argument> &argTable)
+{
+    const std::string shortHelpFlag = R"(-h)",
+                      longHelpFlag = R"(--help)";
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argN = argv[i];
+        
+        if (argN.size() <= 1 || argN[0] != '-')
+            continue;
+        
+        // Check if we need to print the help table and exit the program
+        if (argN.compare(shortHelpFlag) == 0 || argN.compare(longHelpFlag) == 0)
+        {
+            std::string appName = argv[0];
+            auto appDelimPos = appName.find_last_of('/');
+            if (appDelimPos != std::string::npos)
+                appName = appName.substr(appDelimPos + 1);
+            
+            printHelp(title, appName, argTable);
+            argTable.clear();
+            return argTable;
+        }
+
+        // Long names are matched up to the '=' of their value, if any, so that no name is taken for another that
+        // it starts with
+        const bool isLong = argN.size() > 2 && argN[1] == '-';
+        const std::string longName = isLong ? argN.substr(2, argN.find('=') - 2) : std::string();
+        auto it = std::find_if(argTable.begin(), argTable.end(), [&argN, isLong, &longName](const Argument &arg) {
+            return isLong ? longName.compare(arg.longName) == 0 : argN.compare(1, argN.size() - 1, arg.shortName) == 0;
+        });
+
+        if (it == argTable.end())
+            continue;
+
+        std::string argValue;
+        auto delimPos = argN.find('=');
+        if (delimPos != std::string::npos)
+        {
+            argValue = argN.substr(delimPos + 1);
+        }
+        else if (i + 1 < argc)
+        {
+            argValue = argv[i + 1];
+            i++;
+        }
+
+        std::string *valuePtr = it->value;
+        if (valuePtr != nullptr)
+            *valuePtr = argValue.empty() ? it->defaultValue : argValue;
+    }
+
+    for (Argument &arg : argTable)
+    {
+        if (arg.value && arg.value->empty())
+            *(arg.value) = arg.defaultValue;
+    }
+
+    return argTable;
+}
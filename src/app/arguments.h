@@ -0,0 +1,24 @@
+#ifndef _MANDELBROT_APP_ARGUMENTS_H_
+#define _MANDELBROT_APP_ARGUMENTS_H_
+
+#include <string>
+#include <vector>
+
+/// Command line argument, and the string its value is written to
+struct Argument
+{
+    std::string shortName;
+    std::string longName;
+    std::string description;
+    std::string defaultValue;
+    std::string *value;
+};
+
+/// Prints the title of the application, and a description of each argument
+void printHelp(const std::string &title, const std::string &appName, const std::vector<Argument> &argTable);
+
+/// Fills in the values of the arguments given on the command line, and the defaults of the others. If the help
+/// flag is given, the help message is printed and the table is cleared
+std::vector<Argument> &parseArgs(const std::string &title, int argc, char **argv, std::vector<Argument> &argTable);
+
+#endif // _MANDELBROT_APP_ARGUMENTS_H_
@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "color-strategy-gradient.h"
+#include "color/smooth-color-kernel.h"
+
+namespace mandelbrot
+{
+    ColorStrategyGradient::ColorStrategyGradient(Palette palette) :
+        m_palette(std::move(palette)),
+        m_period(64.0),
+        m_offset(0.0),
+        m_vectorized(isSmoothColorKernelSupported())
+    {
+    }
+
+    void ColorStrategyGradient::setPeriod(double iterations)
+    {
+        m_period = iterations;
+    }
+
+    void ColorStrategyGradient::setOffset(double offset)
+    {
+        m_offset = offset;
+    }
+
+    color_t ColorStrategyGradient::getColor(double modZ, double /*modDz*/, int numIterations, int /*maxIterations*/)
+    {
+        // Continuous iteration count, which rises smoothly across the bands of whole iteration counts
+        const double smoothIterations = numIterations + 1.0 - std::log2(std::log(modZ));
+        return m_palette.getColor(smoothIterations / m_period + m_offset);
+    }
+
+    void ColorStrategyGradient::getColors(const float *modZ, const float *modDz, const int *iterations, int count,
+                int maxIterations, color_t *out)
+    {
+        if (!m_vectorized)
+        {
+            colorPixels(*this, modZ, modDz, iterations, count, maxIterations, out);
+            return;
+        }
+
+        const color_t inSet = getColorInSet();
+        const double frequency = 1.0 / m_period;
+        float smoothIterations[SmoothChunkSize];
+        for (int start = 0; start < count; start += SmoothChunkSize)
+        {
+            const int chunk = std::min(count - start, SmoothChunkSize);
+            smoothIterationsAVX2(modZ + start, iterations + start, chunk, smoothIterations);
+            for (int i = 0; i < chunk; ++i)
+            {
+                out[start + i] = iterations[start + i] < maxIterations
+                               ? m_palette.getColor(smoothIterations[i] * frequency + m_offset)
+                               : inSet;
+            }
+        }
+    }
+}
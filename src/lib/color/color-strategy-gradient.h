@@ -0,0 +1,70 @@
+#ifndef _MANDELBROT_LIB_COLOR_STRATEGY_GRADIENT_H_
+#define _MANDELBROT_LIB_COLOR_STRATEGY_GRADIENT_H_
+
+#include "color/color-strategy.h"
+#include "color/palette.h"
+
+namespace mandelbrot
+{
+
+/**
+ * @class ColorStrategyGradient
+ * @brief Colors each pixel from a palette, such as a gradient read from a file, by its smooth iteration count.
+ *        The pixels run through the palette once every given number of iterations, so a cyclic palette
+ *        colors them the same whatever the maximum number of iterations.
+ */
+class ColorStrategyGradient final : public ColorStrategy
+{
+public:
+    explicit ColorStrategyGradient(Palette palette);
+
+    /**
+     * @brief Determines the color for a value outside of the Mandelbrot set.
+     * @param modZ Magnitude of z, the value of the function "z => z^2 + c", once it breached the "in the set" limit
+     * @param modDz Magnitude of the derivative of z, multiplied by the scale of the fractal. Relative to
+     *              the size of a pixel, it stays within range at any zoom level
+     * @param numIterations The number of iterations taken before z breached the "in the set" limit
+     * @param maxIterations The maximum number of iterations before assuming that z is within the set.
+     * @return A color for the given z value
+     */
+    color_t getColor(
+                double modZ,
+                double modDz,
+                int numIterations,
+                int maxIterations) override;
+
+    /// Returns the color that will be rendered for a pixel within the Mandelbrot set
+    /// This is usually black or white
+    color_t getColorInSet() override { return color_t{0xFF000000}; }
+
+    /// Colors a run of pixels, with the continuous iteration counts calculated by \ref smoothIterationsAVX2() where
+    /// the processor supports it, or with the calls to \ref getColor() inlined otherwise
+    void getColors(
+                const float *modZ,
+                const float *modDz,
+                const int *iterations,
+                int count,
+                int maxIterations,
+                color_t *out) override;
+
+    /// Sets the number of iterations over which the palette runs from one end to the other
+    void setPeriod(double iterations);
+
+    /// Sets the position along the palette of the pixels that escape on the first iteration, in [0, 1]
+    void setOffset(double offset);
+
+private:
+    Palette m_palette;
+
+    /// Iterations per repetition of the palette
+    double m_period;
+
+    double m_offset;
+
+    /// Set if the continuous iteration counts of runs of pixels are calculated by \ref smoothIterationsAVX2()
+    bool m_vectorized;
+};
+
+}
+
+#endif // _MANDELBROT_LIB_COLOR_STRATEGY_GRADIENT_H_
@@ -0,0 +1,39 @@
+#include <cmath>
+#include <utility>
+
+#include "color-strategy-histogram.h"
+
+namespace mandelbrot
+{
+    ColorStrategyHistogram::ColorStrategyHistogram(Palette palette) :
+        m_palette(std::move(palette)),
+        m_cumulative(1, 0.0f)
+    {
+    }
+
+    void ColorStrategyHistogram::setHistogram(const IterationHistogram &histogram)
+    {
+        m_cumulative = histogram.getCumulative();
+    }
+
+    color_t ColorStrategyHistogram::getColor(double modZ, double /*modDz*/, int numIterations, int /*maxIterations*/)
+    {
+        // Pixels are placed between the fractions of pixels below their whole iteration count and the next one,
+        // by their continuous iteration count, so that the colors do not form bands
+        const int last = static_cast<int>(m_cumulative.size()) - 1;
+        const double smoothIterations = numIterations + 1.0 - std::log2(std::log2(modZ));
+        const double clamped = smoothIterations > 0.0 ? (smoothIterations < last ? smoothIterations : last) : 0.0;
+        const int n = static_cast<int>(clamped) < last ? static_cast<int>(clamped) : last - 1;
+        if (n < 0)
+            return m_palette.getColor(0.0);
+
+        const double fraction = clamped - n;
+        return m_palette.getColor(m_cumulative[n] + (m_cumulative[n + 1] - m_cumulative[n]) * fraction);
+    }
+
+    void ColorStrategyHistogram::getColors(const float *modZ, const float *modDz, const int *iterations, int count,
+                int maxIterations, color_t *out)
+    {
+        colorPixels(*this, modZ, modDz, iterations, count, maxIterations, out);
+    }
+}
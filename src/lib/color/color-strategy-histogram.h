@@ -0,0 +1,66 @@
+#ifndef _MANDELBROT_LIB_COLOR_STRATEGY_HISTOGRAM_H_
+#define _MANDELBROT_LIB_COLOR_STRATEGY_HISTOGRAM_H_
+
+#include <vector>
+
+#include "color/color-strategy.h"
+#include "color/palette.h"
+
+namespace mandelbrot
+{
+
+/**
+ * @class ColorStrategyHistogram
+ * @brief Histogram equalized coloring. Each pixel is colored from a palette by the fraction of the escaped
+ *        pixels of the frame that took fewer iterations than it did, interpolated along its smooth iteration
+ *        count. The colors are spread evenly over the pixels of any frame, whatever its maximum number of
+ *        iterations, so deep zooms need no tuning of the palette.
+ */
+class ColorStrategyHistogram final : public ColorStrategy
+{
+public:
+    explicit ColorStrategyHistogram(Palette palette);
+
+    /**
+     * @brief Determines the color for a value outside of the Mandelbrot set.
+     * @param modZ Magnitude of z, the value of the function "z => z^2 + c", once it breached the "in the set" limit
+     * @param modDz Magnitude of the derivative of z, multiplied by the scale of the fractal. Relative to
+     *              the size of a pixel, it stays within range at any zoom level
+     * @param numIterations The number of iterations taken before z breached the "in the set" limit
+     * @param maxIterations The maximum number of iterations before assuming that z is within the set.
+     * @return A color for the given z value
+     */
+    color_t getColor(
+                double modZ,
+                double modDz,
+                int numIterations,
+                int maxIterations) override;
+
+    /// Returns the color that will be rendered for a pixel within the Mandelbrot set
+    /// This is usually black or white
+    color_t getColorInSet() override { return color_t{0xFF000000}; }
+
+    /// Colors a run of pixels, with the calls to \ref getColor() inlined
+    void getColors(
+                const float *modZ,
+                const float *modDz,
+                const int *iterations,
+                int count,
+                int maxIterations,
+                color_t *out) override;
+
+    bool usesHistogram() const override { return true; }
+
+    /// Keeps the cumulative distribution of the histogram, which the colors of the pixels are looked up in
+    void setHistogram(const IterationHistogram &histogram) override;
+
+private:
+    Palette m_palette;
+
+    /// See \ref IterationHistogram::getCumulative()
+    std::vector<float> m_cumulative;
+};
+
+}
+
+#endif // _MANDELBROT_LIB_COLOR_STRATEGY_HISTOGRAM_H_
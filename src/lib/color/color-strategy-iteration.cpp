@@ -2,13 +2,9 @@
 
 namespace mandelbrot
 {
-    color_t ColorStrategyIteration::getColor(std::complex<double> /*z*/,
-                std::complex<double> /*dZ*/,
-                double /*scale*/,
-                int numIterations,
-                int maxIterations)
+    /// Returns the color of a pixel that took the given fraction of the maximum number of iterations
+    static color_t polynomialColor(double n)
     {
-        const double n = static_cast<double>(numIterations) / static_cast<double>(maxIterations);
         const double n2 = 1.0 - n;
         int r = static_cast<int>(9 * n2 * n * n * n * 255);
         int g = static_cast<int>(15 * n2 * n2 * n * n * 255);
@@ -22,25 +18,22 @@ namespace mandelbrot
         return result;
     }
 
-    color_t ColorStrategyIteration::getColorPrecise(mpfr_ptr /*zReal*/,
-                    mpfr_ptr /*zIm*/,
-                    mpfr_ptr /*dzReal*/,
-                    mpfr_ptr /*dzIm*/,
-                    double /*scale*/,
-                    int numIterations,
-                    int maxIterations)
+    ColorStrategyIteration::ColorStrategyIteration() :
+        m_palette(Palette::fromFunction(&polynomialColor, false))
     {
-        const double n = static_cast<double>(numIterations) / static_cast<double>(maxIterations);
-        const double n2 = 1.0 - n;
-        int r = static_cast<int>(9 * n2 * n * n * n * 255);
-        int g = static_cast<int>(15 * n2 * n2 * n * n * 255);
-        int b = static_cast<int>(8.5 * n2 * n2 * n2 * n * 255);
+    }
 
-        color_t result;
-        result.argb.a = 0xFF;
-        result.argb.r = static_cast<uint8_t>(r);
-        result.argb.g = static_cast<uint8_t>(g);
-        result.argb.b = static_cast<uint8_t>(b);
-        return result;
+    color_t ColorStrategyIteration::getColor(double /*modZ*/,
+                double /*modDz*/,
+                int numIterations,
+                int maxIterations)
+    {
+        return m_palette.getColor(static_cast<double>(numIterations) / static_cast<double>(maxIterations));
+    }
+
+    void ColorStrategyIteration::getColors(const float *modZ, const float *modDz, const int *iterations, int count,
+                int maxIterations, color_t *out)
+    {
+        colorPixels(*this, modZ, modDz, iterations, count, maxIterations, out);
     }
 }
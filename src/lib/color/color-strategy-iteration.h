@@ -2,6 +2,7 @@
 #define _MANDELBROT_LIB_COLOR_STRATEGY_ITERATION_H_
 
 #include "color/color-strategy.h"
+#include "color/palette.h"
 
 namespace mandelbrot
 {
@@ -9,45 +10,39 @@ namespace mandelbrot
 class ColorStrategyIteration final : public ColorStrategy
 {
 public:
+    ColorStrategyIteration();
+
     /**
      * @brief Determines the color for a value outside of the Mandelbrot set.
-     * @param z The value of the function "z => z^2 + c"
-     * @param dZ The derivative of z
-     * @param scale The scale of the fractal
+     * @param modZ Magnitude of z, the value of the function "z => z^2 + c", once it breached the "in the set" limit
+     * @param modDz Magnitude of the derivative of z, multiplied by the scale of the fractal. Relative to
+     *              the size of a pixel, it stays within range at any zoom level
      * @param numIterations The number of iterations taken before z breached the "in the set" limit
      * @param maxIterations The maximum number of iterations before assuming that z is within the set.
      * @return A color for the given z value
      */
     color_t getColor(
-                std::complex<double> z,
-                std::complex<double> dZ,
-                double scale,
+                double modZ,
+                double modDz,
                 int numIterations,
                 int maxIterations) override;
 
-    /**
-     * @brief Determines the color for a value outside of the Mandelbrot set.
-     * @param zReal The real portion of the z output from the function "z => z^2 + c"
-     * @param zIm The imaginary portion of the z output from the function "z => z^2 + c"
-     * @param dzReal The real portion of the derivative of z
-     * @param dzIm The imaginary portion of the derivative of z
-     * @param scale The scale of the fractal
-     * @param numIterations The number of iterations taken before z breached the "in the set" limit
-     * @param maxIterations The maximum number of iterations before assuming that z is within the set.
-     * @return A color for the given z value
-     */
-    color_t getColorPrecise(
-                    mpfr_ptr zReal,
-                    mpfr_ptr zIm,
-                    mpfr_ptr dzReal,
-                    mpfr_ptr dzIm,
-                    double scale,
-                    int numIterations,
-                    int maxIterations) override;
-
     /// Returns the color that will be rendered for a pixel within the Mandelbrot set
     /// This is usually black or white
     color_t getColorInSet() override { return color_t{0xFF000000}; }
+
+    /// Colors a run of pixels, with the calls to \ref getColor() inlined
+    void getColors(
+                const float *modZ,
+                const float *modDz,
+                const int *iterations,
+                int count,
+                int maxIterations,
+                color_t *out) override;
+
+private:
+    /// Polynomials of the fraction of the maximum number of iterations taken, compiled into a lookup table
+    Palette m_palette;
 };
 
 }
@@ -1,23 +1,27 @@
 #include <cmath>
-#include <complex>
 
 #include "color-strategy-smooth.h"
+#include "color/smooth-color-kernel.h"
 
 namespace mandelbrot
 {
     const static double lnP = 0.693;
     const static double lle = 7.847;
 
-    ColorStrategySmooth::ColorStrategySmooth() : ColorStrategy(),
-        m_colorIntensity{-0.1275},
-        m_temp{}
+    bool isSmoothColorKernelSupported()
     {
-        mpfr_init2(m_temp, 128);
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+        return false;
+#endif
     }
 
-    ColorStrategySmooth::~ColorStrategySmooth()
+    ColorStrategySmooth::ColorStrategySmooth() :
+        m_colorIntensity(-0.1275),
+        m_vectorized(isSmoothColorKernelSupported())
     {
-        mpfr_clear(m_temp);
     }
 
     void ColorStrategySmooth::setColorIntensity(double colorIntensity)
@@ -25,19 +29,17 @@ namespace mandelbrot
         m_colorIntensity = colorIntensity;
     }
 
-    color_t ColorStrategySmooth::getColor(std::complex<double> z, std::complex<double> dZ,
-            double scale, int numIterations, int /*maxIterations*/)
+    color_t ColorStrategySmooth::getColor(double modZ, double modDz, int numIterations, int /*maxIterations*/)
     {
-        const double modZ = std::abs(z);
-        const double absDz = std::abs(dZ);
         const double logModZ = std::log(modZ);
 
         double V = 1;
         double dist, distScale;
-        if (absDz > 0)
+        if (modDz > 0)
         {
-            dist = 2.0 * modZ * logModZ / absDz;
-            distScale = std::log(dist / scale) / lnP - 1.2;
+            // Distance estimate, in pixels
+            dist = 2.0 * modZ * logModZ / modDz;
+            distScale = std::log(dist) / lnP - 1.2;
             
             if (distScale < -8)
                 V = 0;
@@ -72,60 +74,6 @@ namespace mandelbrot
         return hsvToRgba(H, S, V);
     }
 
-    color_t ColorStrategySmooth::getColorPrecise(mpfr_ptr zReal, mpfr_ptr zIm,
-                    mpfr_ptr dzReal, mpfr_ptr dzIm, double scale, int numIterations, int /*maxIterations*/)
-    {
-        // Abs(complex) = sqrt(real^2  + imag^2)
-        mpfr_fmma(m_temp, zReal, zReal, zIm, zIm, MPFR_RNDN);
-        mpfr_sqrt(m_temp, m_temp, MPFR_RNDN);
-        const double modZ = mpfr_get_d(m_temp, MPFR_RNDN);
-
-        mpfr_fmma(m_temp, dzReal, dzReal, dzIm, dzIm, MPFR_RNDN);
-        mpfr_sqrt(m_temp, m_temp, MPFR_RNDN);
-        const double absDz = mpfr_get_d(m_temp, MPFR_RNDN);
-
-        const double logModZ = std::log(modZ);
-
-        double V = 1;
-        double dist, distScale;
-        if (absDz > 0)
-        {
-            dist = 2.0 * modZ * logModZ / absDz;
-            distScale = std::log(dist / scale) / lnP - 1.2;
-
-            if (distScale < -8)
-                V = 0;
-            else if (distScale < 0)
-                V = 1.0 + distScale / 8.0;
-        }
-
-        double dwell = (double)numIterations - std::log(logModZ) / lnP + lle;
-        double q = std::log(std::abs(dwell)) * std::abs(m_colorIntensity);
-        double angle;
-
-        if (q < 0.5)
-        {
-            q = 1.0 - 1.5 * q;
-            angle = 1.0 - q;
-        }
-        else
-        {
-            q = 1.5 * q - 0.5;
-            angle = q;
-        }
-
-        double radius = std::sqrt(q);
-        if (numIterations % 2 == 1 && m_colorIntensity > 0.0)
-        {
-            V = 0.85 * V;
-            radius = 0.667 * radius;
-        }
-        double ignore;
-        double H = std::modf(angle * 10, &ignore) * 360;
-        double S = std::modf(radius, &ignore);
-        return hsvToRgba(H, S, V);
-    }
-
     color_t ColorStrategySmooth::hsvToRgba(double hue, double saturation, double value) const
     {
         color_t result;
@@ -190,4 +138,13 @@ namespace mandelbrot
         result.argb.b = static_cast<uint8_t>(b * 255.0);
         return result;
     }
+
+    void ColorStrategySmooth::getColors(const float *modZ, const float *modDz, const int *iterations, int count,
+                int maxIterations, color_t *out)
+    {
+        if (m_vectorized)
+            smoothColorsAVX2(modZ, modDz, iterations, count, maxIterations, m_colorIntensity, getColorInSet(), out);
+        else
+            colorPixels(*this, modZ, modDz, iterations, count, maxIterations, out);
+    }
 }
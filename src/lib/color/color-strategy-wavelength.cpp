@@ -1,57 +1,67 @@
+#include <algorithm>
 #include <cmath>
 
 #include "color-strategy-wavelength.h"
+#include "color/smooth-color-kernel.h"
 
 namespace mandelbrot
 {
     static constexpr double logBase = 1.44269504089;
     static constexpr double logHalfBase = -1.0;
 
+    /// Number of radians the phase of the channels advances by over the palette
+    static constexpr double phaseRange = 0.2 * 511;
+
     ColorStrategyWavelength::ColorStrategyWavelength() :
-        m_colorMap{}
-    {
-        for (int i = 0; i < 512; ++i)
-        {
+        m_palette(Palette::fromFunction([](double position) {
+            const double phase = position * phaseRange;
             color_t c { 0xFF000000 };
-            auto r = std::sin(0.2 * i) * 127.5 + 127.5,
-                 g = std::sin(0.2 * i + 2) * 127.5 + 127.5,
-                 b = std::sin(0.2 * i + 4) * 127.5 + 127.5;
+            auto r = std::sin(phase) * 127.5 + 127.5,
+                 g = std::sin(phase + 2) * 127.5 + 127.5,
+                 b = std::sin(phase + 4) * 127.5 + 127.5;
             c.argb.r = static_cast<uint8_t>(r);
             c.argb.g = static_cast<uint8_t>(g);
             c.argb.b = static_cast<uint8_t>(b);
-            m_colorMap[i] = c;
-        }
+            return c;
+        }, false)),
+        m_vectorized(isSmoothColorKernelSupported())
+    {
     }
 
     color_t ColorStrategyWavelength::getColor(
-                std::complex<double> z,
-                std::complex<double> /*dZ*/,
-                double /*scale*/,
+                double modZ,
+                double /*modDz*/,
                 int numIterations,
                 int maxIterations)
     {
-        double n = 5.0 + numIterations - logHalfBase - std::log(std::log(std::norm(z))) * logBase;
-        double normalized = n / static_cast<double>(maxIterations);
-        return m_colorMap[static_cast<int>(normalized * 511)];
+        double n = 5.0 + numIterations - logHalfBase - std::log(std::log(modZ * modZ)) * logBase;
+        return m_palette.getColor(n / static_cast<double>(maxIterations));
     }
 
-    color_t ColorStrategyWavelength::getColorPrecise(
-                    mpfr_ptr zReal,
-                    mpfr_ptr zIm,
-                    mpfr_ptr temp,
-                    mpfr_ptr temp2,
-                    double /*scale*/,
-                    int numIterations,
-                    int maxIterations)
+    void ColorStrategyWavelength::getColors(const float *modZ, const float *modDz, const int *iterations, int count,
+                int maxIterations, color_t *out)
     {
-        //norm(z) = zReal * zReal + zIm * zIm
-        mpfr_sqr(temp, zReal, MPFR_RNDN);
-        mpfr_sqr(temp2, zIm, MPFR_RNDN);
-        mpfr_add(temp, temp, temp2, MPFR_RNDN);
+        if (!m_vectorized)
+        {
+            colorPixels(*this, modZ, modDz, iterations, count, maxIterations, out);
+            return;
+        }
 
-        double n = 5.0 + numIterations - logHalfBase - std::log(std::log(mpfr_get_d(temp, MPFR_RNDN))) * logBase;
-        double normalized = n / static_cast<double>(maxIterations);
-        return m_colorMap[static_cast<int>(normalized * 511)];
+        // The continuous iteration counts of a chunk of pixels are calculated 8 at a time, then looked up.
+        // 5 - logHalfBase - log2(ln(|z|^2)) is 5 - log2(ln|z|), 4 more than the count of the kernel
+        const color_t inSet = getColorInSet();
+        const double scale = 1.0 / static_cast<double>(maxIterations);
+        float smoothIterations[SmoothChunkSize];
+        for (int start = 0; start < count; start += SmoothChunkSize)
+        {
+            const int chunk = std::min(count - start, SmoothChunkSize);
+            smoothIterationsAVX2(modZ + start, iterations + start, chunk, smoothIterations);
+            for (int i = 0; i < chunk; ++i)
+            {
+                out[start + i] = iterations[start + i] < maxIterations
+                               ? m_palette.getColor((smoothIterations[i] + 4.0) * scale)
+                               : inSet;
+            }
+        }
     }
 }
-
@@ -1,10 +1,8 @@
 #ifndef _MANDELBROT_LIB_COLOR_STRATEGY_H_
 #define _MANDELBROT_LIB_COLOR_STRATEGY_H_
 
-#include <complex>
-#include <mpfr.h>
-
 #include "color/color.h"
+#include "iteration-histogram.h"
 
 namespace mandelbrot
 {
@@ -14,43 +12,71 @@ class ColorStrategy
 public:
     /**
      * @brief Determines the color for a value outside of the Mandelbrot set.
-     * @param z The value of the function "z => z^2 + c"
-     * @param dZ The derivative of z
-     * @param scale The scale of the fractal
+     * @param modZ Magnitude of z, the value of the function "z => z^2 + c", once it breached the "in the set" limit
+     * @param modDz Magnitude of the derivative of z, multiplied by the scale of the fractal. Relative to
+     *              the size of a pixel, it stays within range at any zoom level
      * @param numIterations The number of iterations taken before z breached the "in the set" limit
      * @param maxIterations The maximum number of iterations before assuming that z is within the set.
      * @return A color for the given z value
      */
     virtual color_t getColor(
-                std::complex<double> z,
-                std::complex<double> dZ,
-                double scale,
+                double modZ,
+                double modDz,
                 int numIterations,
                 int maxIterations) = 0;
 
+    /// Returns the color that will be rendered for a pixel within the Mandelbrot set
+    /// This is usually black or white
+    virtual color_t getColorInSet() = 0;
+
     /**
-     * @brief Determines the color for a value outside of the Mandelbrot set.
-     * @param zReal The real portion of the z output from the function "z => z^2 + c"
-     * @param zIm The imaginary portion of the z output from the function "z => z^2 + c"
-     * @param dzReal The real portion of the derivative of z
-     * @param dzIm The imaginary portion of the derivative of z
-     * @param scale The scale of the fractal
-     * @param numIterations The number of iterations taken before z breached the "in the set" limit
+     * @brief Determines the colors of a run of pixels, within the set or not, from their escape time data.
+     *        Called once per row of a tile rather than calling \ref getColor() for each pixel. The default
+     *        calls \ref getColor() or \ref getColorInSet() for each pixel in turn.
+     * @param modZ Magnitude of z of each pixel, see \ref getColor()
+     * @param modDz Magnitude of the scaled derivative of z of each pixel, see \ref getColor()
+     * @param iterations Number of iterations of each pixel. Pixels with maxIterations or more are within the set
+     * @param count Number of pixels in the run
      * @param maxIterations The maximum number of iterations before assuming that z is within the set.
-     * @return A color for the given z value
+     * @param out Colors of the pixels
      */
-    virtual color_t getColorPrecise(
-                mpfr_ptr zReal,
-                mpfr_ptr zIm,
-                mpfr_ptr dzReal,
-                mpfr_ptr dzIm,
-                double scale,
-                int numIterations,
-                int maxIterations) = 0;
+    virtual void getColors(
+                const float *modZ,
+                const float *modDz,
+                const int *iterations,
+                int count,
+                int maxIterations,
+                color_t *out)
+    {
+        colorPixels(*this, modZ, modDz, iterations, count, maxIterations, out);
+    }
 
-    /// Returns the color that will be rendered for a pixel within the Mandelbrot set
-    /// This is usually black or white
-    virtual color_t getColorInSet() = 0;
+    /// Returns true if the strategy colors pixels by the distribution of the iteration counts of the frame. The
+    /// distribution is then gathered while the frame is rendered, and handed to \ref setHistogram() before the
+    /// frame is colored
+    virtual bool usesHistogram() const { return false; }
+
+    /// Receives the distribution of the iteration counts of the pixels about to be colored
+    virtual void setHistogram(const IterationHistogram & /*histogram*/) {}
+
+    virtual ~ColorStrategy() = default;
+
+protected:
+    /// Colors a run of pixels with the \ref getColor() and \ref getColorInSet() of the given type of strategy. The
+    /// strategies of this library override \ref getColors() with a call to this function for their own final type,
+    /// from the source file defining them, so that the calls are bound at compile time and inlined into the loop
+    template <typename Strategy>
+    static void colorPixels(Strategy &strategy, const float *modZ, const float *modDz, const int *iterations,
+                            int count, int maxIterations, color_t *out)
+    {
+        const color_t inSet = strategy.getColorInSet();
+        for (int i = 0; i < count; ++i)
+        {
+            out[i] = iterations[i] < maxIterations
+                   ? strategy.getColor(modZ[i], modDz[i], iterations[i], maxIterations)
+                   : inSet;
+        }
+    }
 };
 
 }
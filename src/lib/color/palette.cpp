@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "color/palette.h"
+
+namespace mandelbrot
+{
+    /// Gradients that come with the library, as stops of a cyclic palette
+    struct NamedGradient
+    {
+        const char *name;
+        std::vector<GradientStop> stops;
+    };
+
+    static const NamedGradient NamedGradients[] = {
+        { "classic", { { 0.0, color_t{0xFF000764} }, { 0.16, color_t{0xFF206BCB} }, { 0.42, color_t{0xFFEDFFFF} },
+                       { 0.6425, color_t{0xFFFFAA00} }, { 0.8575, color_t{0xFF000200} } } },
+        { "fire", { { 0.0, color_t{0xFF000000} }, { 0.25, color_t{0xFF800000} }, { 0.5, color_t{0xFFFF5A00} },
+                    { 0.75, color_t{0xFFFFE040} }, { 0.9, color_t{0xFFFFFFF0} } } },
+        { "ice", { { 0.0, color_t{0xFF00081A} }, { 0.3, color_t{0xFF1B4F8A} }, { 0.55, color_t{0xFF7CC4E8} },
+                   { 0.7, color_t{0xFFF4FBFF} }, { 0.85, color_t{0xFF3A7BB0} } } },
+        { "grayscale", { { 0.0, color_t{0xFF000000} }, { 0.5, color_t{0xFFFFFFFF} } } }
+    };
+
+    /// Returns the color a given fraction of the way from a to b
+    static color_t interpolate(color_t a, color_t b, double fraction)
+    {
+        auto channel = [fraction](uint8_t x, uint8_t y) {
+            return static_cast<uint8_t>(x + (y - x) * fraction + 0.5);
+        };
+
+        color_t result;
+        result.argb.a = channel(a.argb.a, b.argb.a);
+        result.argb.r = channel(a.argb.r, b.argb.r);
+        result.argb.g = channel(a.argb.g, b.argb.g);
+        result.argb.b = channel(a.argb.b, b.argb.b);
+        return result;
+    }
+
+    Palette::Palette() :
+        m_colors(Size + 2, color_t{0xFF000000}),
+        m_cyclic(false)
+    {
+    }
+
+    Palette Palette::fromFunction(const std::function<color_t(double)> &mapping, bool cyclic)
+    {
+        Palette palette;
+        palette.m_cyclic = cyclic;
+        for (int i = 0; i < Size; ++i)
+            palette.m_colors[i] = mapping(static_cast<double>(i) / Size);
+        palette.m_colors[Size] = cyclic ? palette.m_colors[0] : mapping(1.0);
+        palette.m_colors[Size + 1] = palette.m_colors[Size];
+        return palette;
+    }
+
+    Palette Palette::fromStops(std::vector<GradientStop> stops, bool cyclic)
+    {
+        if (stops.empty())
+            throw std::invalid_argument("A gradient needs at least one stop");
+
+        std::stable_sort(stops.begin(), stops.end(), [](const GradientStop &a, const GradientStop &b) {
+            return a.position < b.position;
+        });
+
+        return fromFunction([&stops, cyclic](double position) {
+            const auto next = std::upper_bound(stops.begin(), stops.end(), position, [](double p, const GradientStop &stop) {
+                return p < stop.position;
+            });
+
+            // Past either end, a cyclic gradient runs from its last stop to its first one, one cycle on
+            if (next == stops.begin() || next == stops.end())
+            {
+                if (!cyclic)
+                    return next == stops.begin() ? stops.front().color : stops.back().color;
+
+                const GradientStop &last = stops.back(), &first = stops.front();
+                const double span = first.position + 1.0 - last.position;
+                const double offset = next == stops.end() ? position - last.position : position + 1.0 - last.position;
+                return span > 0.0 ? interpolate(last.color, first.color, offset / span) : first.color;
+            }
+
+            const GradientStop &before = *(next - 1), &after = *next;
+            return interpolate(before.color, after.color, (position - before.position) / (after.position - before.position));
+        }, cyclic);
+    }
+
+    Palette Palette::fromFile(const std::string &fileName)
+    {
+        std::ifstream file(fileName);
+        if (!file)
+            throw std::runtime_error("Cannot read gradient file: " + fileName);
+
+        std::vector<GradientStop> stops;
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(file, line))
+        {
+            ++lineNumber;
+            const size_t first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#')
+                continue;
+
+            std::istringstream fields(line);
+            double position = 0.0;
+            std::string hex;
+            fields >> position >> hex;
+            if (!hex.empty() && hex[0] == '#')
+                hex.erase(0, 1);
+
+            const bool valid = !fields.fail() && position >= 0.0 && position <= 1.0 && hex.size() == 6
+                               && std::all_of(hex.begin(), hex.end(), [](char c) { return std::isxdigit(static_cast<unsigned char>(c)) != 0; });
+            if (!valid)
+                throw std::invalid_argument(fileName + ":" + std::to_string(lineNumber) + ": expected a position and a color, as in \"0.5 #FF8000\"");
+
+            stops.push_back(GradientStop { position, color_t{0xFF000000u | static_cast<uint32_t>(std::stoul(hex, nullptr, 16))} });
+        }
+
+        if (stops.empty())
+            throw std::invalid_argument("No gradient stops in " + fileName);
+
+        return fromStops(std::move(stops), true);
+    }
+
+    Palette Palette::fromName(const std::string &name)
+    {
+        for (const NamedGradient &gradient : NamedGradients)
+        {
+            if (name == gradient.name)
+                return fromStops(gradient.stops, true);
+        }
+
+        throw std::invalid_argument("No such gradient: " + name);
+    }
+
+    std::vector<std::string> Palette::getNames()
+    {
+        std::vector<std::string> names;
+        for (const NamedGradient &gradient : NamedGradients)
+            names.push_back(gradient.name);
+        return names;
+    }
+
+    bool Palette::isCyclic() const noexcept
+    {
+        return m_cyclic;
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef _MANDELBROT_LIB_COLOR_PALETTE_H_
+#define _MANDELBROT_LIB_COLOR_PALETTE_H_
+
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "color/color.h"
+
+namespace mandelbrot
+{
+
+/// Color of a gradient at a given position, see \ref Palette::fromStops()
+struct GradientStop
+{
+    /// Position along the gradient, in [0, 1]
+    double position;
+
+    color_t color;
+};
+
+/**
+ * @class Palette
+ * @brief Mapping from a position in [0, 1] to a color, compiled into a lookup table small enough to stay in the
+ *        cache. Positions between two entries are colored by interpolating linearly between them, so that a
+ *        continuous quantity such as the smooth iteration count of a pixel is colored without banding.
+ *        A cyclic palette repeats itself past either end, while the positions of any other palette are clamped.
+ */
+class Palette
+{
+public:
+    /// Number of entries in the lookup table, sampled at positions 0, 1/Size, .., 1
+    static constexpr int Size = 1024;
+
+    /// Constructs a black palette
+    Palette();
+
+    /// Samples the given mapping from positions in [0, 1] to colors
+    static Palette fromFunction(const std::function<color_t(double)> &mapping, bool cyclic);
+
+    /**
+     * @brief Constructs a gradient interpolating linearly between the colors of the given stops. Positions before
+     *        the first stop and after the last one take on their colors, or in a cyclic palette, interpolate
+     *        between the last stop and the first.
+     * @throws std::invalid_argument if there are no stops
+     */
+    static Palette fromStops(std::vector<GradientStop> stops, bool cyclic);
+
+    /**
+     * @brief Reads a cyclic gradient from a text file. Each line holds a stop: its position in [0, 1], followed
+     *        by its color in hexadecimal, as in "0.25 #20A0FF". Empty lines and lines starting with # are skipped.
+     * @throws std::runtime_error if the file cannot be read, std::invalid_argument if it holds no valid gradient
+     */
+    static Palette fromFile(const std::string &fileName);
+
+    /**
+     * @brief Returns one of the cyclic gradients that come with the library
+     * @throws std::invalid_argument if there is no such gradient
+     */
+    static Palette fromName(const std::string &name);
+
+    /// Returns the names of the gradients accepted by \ref fromName()
+    static std::vector<std::string> getNames();
+
+    bool isCyclic() const noexcept;
+
+    /// Returns the color at the given position, interpolated between the two nearest entries of the table. Defined
+    /// here so that it is inlined into the loops of the color strategies
+    color_t getColor(double position) const
+    {
+        // Positions that are not numbers take on the first color. The position is converted to fixed point once,
+        // with the index of the entry in the upper bits and the weight of the next one in the lower 8
+        double x = m_cyclic ? position - std::floor(position) : position;
+        x = x > 0.0 ? (x < 1.0 ? x : 1.0) : 0.0;
+
+        const uint32_t fixed = static_cast<uint32_t>(x * (Size * 256));
+        const uint32_t index = fixed >> 8;
+        const uint32_t weight = fixed & 0xFFu;
+
+        // Two channels are interpolated at a time, each in 16 bits of a 32 bit word
+        const uint32_t a = m_colors[index].raw, b = m_colors[index + 1].raw;
+        const uint32_t rb = (((a & 0x00FF00FFu) * (256 - weight) + (b & 0x00FF00FFu) * weight + 0x00800080u) >> 8) & 0x00FF00FFu;
+        const uint32_t ag = (((a >> 8) & 0x00FF00FFu) * (256 - weight) + ((b >> 8) & 0x00FF00FFu) * weight + 0x00800080u) & 0xFF00FF00u;
+        color_t result;
+        result.raw = ag | rb;
+        return result;
+    }
+
+private:
+    /// Entries of the table, Size + 2 of them. Entry Size of a cyclic palette is its first, and the last entry
+    /// repeats entry Size, so that position 1 can be looked up as entry Size with a weight of zero
+    std::vector<color_t> m_colors;
+
+    bool m_cyclic;
+};
+
+}
+
+#endif // _MANDELBROT_LIB_COLOR_PALETTE_H_
@@ -0,0 +1,165 @@
+#include <immintrin.h>
+
+#include "color/smooth-color-kernel.h"
+
+// This translation unit is compiled with -mavx2 -mfma. See kernel/escape-time-kernel-avx2.cpp
+// regarding the inclusion of other headers.
+
+namespace mandelbrot
+{
+    // The constants of ColorStrategySmooth
+    static constexpr float lnP = 0.693f;
+    static constexpr float lle = 7.847f;
+
+    /**
+     * @brief Natural logarithm of 8 positive, finite floats. The mantissa is brought into [sqrt(1/2), sqrt(2)),
+     *        and the logarithm of it approximated by the polynomial of Cephes' logf, which is accurate to a few
+     *        units in the last place. Infinity is given a large finite value.
+     */
+    static __m256 log8(__m256 x)
+    {
+        const __m256 one = _mm256_set1_ps(1.0f);
+
+        // x = m * 2^e, with m in [0.5, 1)
+        const __m256i bits = _mm256_castps_si256(x);
+        __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+        __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)),
+                                                       _mm256_set1_epi32(0x3F000000)));
+
+        // Mantissas below sqrt(1/2) are doubled, so that m - 1 lies in [sqrt(1/2) - 1, sqrt(2) - 1)
+        const __m256 small = _mm256_cmp_ps(m, _mm256_set1_ps(0.707106781186547524f), _CMP_LT_OQ);
+        e = _mm256_sub_ps(e, _mm256_and_ps(small, one));
+        m = _mm256_add_ps(_mm256_sub_ps(m, one), _mm256_and_ps(small, m));
+
+        const __m256 m2 = _mm256_mul_ps(m, m);
+        __m256 y = _mm256_set1_ps(7.0376836292e-2f);
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.1514610310e-1f));
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(1.1676998740e-1f));
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.2420140846e-1f));
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(1.4249322787e-1f));
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.6668057665e-1f));
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(2.0000714765e-1f));
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-2.4999993993e-1f));
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(3.3333331174e-1f));
+        y = _mm256_mul_ps(_mm256_mul_ps(y, m), m2);
+
+        // ln(2) is split in two, so that e * ln(2) adds no rounding error of its own
+        y = _mm256_fmadd_ps(e, _mm256_set1_ps(-2.12194440e-4f), y);
+        y = _mm256_fnmadd_ps(_mm256_set1_ps(0.5f), m2, y);
+        return _mm256_fmadd_ps(e, _mm256_set1_ps(0.693359375f), _mm256_add_ps(m, y));
+    }
+
+    /// Fractional part of each float, with the sign of the float as std::modf gives it
+    static __m256 fraction8(__m256 x)
+    {
+        return _mm256_sub_ps(x, _mm256_round_ps(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+    }
+
+    /// Converts each float in [0, 1] to a color channel, truncating as a cast does
+    static __m256i channel8(__m256 x)
+    {
+        return _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(255.0f)));
+    }
+
+    void smoothColorsAVX2(const float *modZ, const float *modDz, const int *iterations, int count, int maxIterations,
+                          double colorIntensity, color_t inSet, color_t *out)
+    {
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 intensity = _mm256_set1_ps(static_cast<float>(colorIntensity < 0.0 ? -colorIntensity : colorIntensity));
+        const bool darkenOdd = colorIntensity > 0.0;
+        const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i oneInt = _mm256_set1_epi32(1);
+        const __m256i maxIter = _mm256_set1_epi32(maxIterations);
+        const __m256i sign = _mm256_set1_epi32(0x7FFFFFFF);
+
+        for (int i = 0; i < count; i += 8)
+        {
+            // The lanes past the end of the run are neither loaded nor stored
+            const __m256i used = _mm256_cmpgt_epi32(_mm256_set1_epi32(count - i), lanes);
+            const __m256 z = _mm256_maskload_ps(modZ + i, used);
+            const __m256 dz = _mm256_maskload_ps(modDz + i, used);
+            const __m256i n = _mm256_maskload_epi32(iterations + i, used);
+
+            const __m256 logModZ = log8(z);
+
+            // Value, from the distance estimate in pixels. The value of pixels without a derivative is 1
+            const __m256 dist = _mm256_div_ps(_mm256_mul_ps(_mm256_add_ps(z, z), logModZ), dz);
+            const __m256 distScale = _mm256_sub_ps(_mm256_div_ps(log8(dist), _mm256_set1_ps(lnP)), _mm256_set1_ps(1.2f));
+            __m256 v = _mm256_min_ps(_mm256_max_ps(_mm256_fmadd_ps(distScale, _mm256_set1_ps(0.125f), one), zero), one);
+            v = _mm256_blendv_ps(one, v, _mm256_cmp_ps(dz, zero, _CMP_GT_OQ));
+
+            const __m256 dwell = _mm256_add_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(n),
+                                                             _mm256_div_ps(log8(logModZ), _mm256_set1_ps(lnP))),
+                                               _mm256_set1_ps(lle));
+            __m256 q = _mm256_mul_ps(log8(_mm256_and_ps(dwell, _mm256_castsi256_ps(sign))), intensity);
+
+            const __m256 low = _mm256_cmp_ps(q, _mm256_set1_ps(0.5f), _CMP_LT_OQ);
+            q = _mm256_blendv_ps(_mm256_fmsub_ps(q, _mm256_set1_ps(1.5f), _mm256_set1_ps(0.5f)),
+                                 _mm256_fnmadd_ps(q, _mm256_set1_ps(1.5f), one), low);
+            const __m256 angle = _mm256_blendv_ps(q, _mm256_sub_ps(one, q), low);
+            __m256 radius = _mm256_sqrt_ps(q);
+
+            if (darkenOdd)
+            {
+                const __m256 odd = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(n, oneInt), oneInt));
+                v = _mm256_blendv_ps(v, _mm256_mul_ps(v, _mm256_set1_ps(0.85f)), odd);
+                radius = _mm256_blendv_ps(radius, _mm256_mul_ps(radius, _mm256_set1_ps(0.667f)), odd);
+            }
+
+            const __m256 hue = _mm256_mul_ps(fraction8(_mm256_mul_ps(angle, _mm256_set1_ps(10.0f))), _mm256_set1_ps(360.0f));
+            const __m256 s = fraction8(radius);
+
+            // HSV to RGB. Each channel is one of v, p, q or t depending on the sector of the hue, which is
+            // picked with masks rather than branches. The sectors past the last one are taken as the last
+            const __m256 sector = _mm256_div_ps(hue, _mm256_set1_ps(60.0f));
+            const __m256i index = _mm256_cvttps_epi32(sector);
+            const __m256 f = fraction8(sector);
+            const __m256 p = _mm256_mul_ps(v, _mm256_sub_ps(one, s));
+            const __m256 qv = _mm256_mul_ps(v, _mm256_fnmadd_ps(s, f, one));
+            const __m256 t = _mm256_mul_ps(v, _mm256_fnmadd_ps(s, _mm256_sub_ps(one, f), one));
+
+            auto isSector = [index](int k) {
+                return _mm256_castsi256_ps(_mm256_cmpeq_epi32(index, _mm256_set1_epi32(k)));
+            };
+            const __m256 s0 = isSector(0), s1 = isSector(1), s2 = isSector(2), s3 = isSector(3), s4 = isSector(4);
+
+            __m256 r = v, g = p, b = qv;
+            r = _mm256_blendv_ps(r, qv, s1);
+            r = _mm256_blendv_ps(r, p, _mm256_or_ps(s2, s3));
+            r = _mm256_blendv_ps(r, t, s4);
+            g = _mm256_blendv_ps(g, t, s0);
+            g = _mm256_blendv_ps(g, v, _mm256_or_ps(s1, s2));
+            g = _mm256_blendv_ps(g, qv, s3);
+            b = _mm256_blendv_ps(b, p, _mm256_or_ps(s0, s1));
+            b = _mm256_blendv_ps(b, t, s2);
+            b = _mm256_blendv_ps(b, v, _mm256_or_ps(s3, s4));
+
+            __m256i argb = _mm256_or_si256(_mm256_set1_epi32(static_cast<int>(0xFF000000u)),
+                                           _mm256_or_si256(_mm256_slli_epi32(channel8(r), 16),
+                                                           _mm256_or_si256(_mm256_slli_epi32(channel8(g), 8), channel8(b))));
+
+            const __m256i escaped = _mm256_cmpgt_epi32(maxIter, n);
+            argb = _mm256_blendv_epi8(_mm256_set1_epi32(static_cast<int>(inSet.raw)), argb, escaped);
+            _mm256_maskstore_epi32(reinterpret_cast<int *>(out + i), used, argb);
+        }
+    }
+
+    void smoothIterationsAVX2(const float *modZ, const int *iterations, int count, float *out)
+    {
+        const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+        for (int i = 0; i < count; i += 8)
+        {
+            // The lanes past the end of the run are neither loaded nor stored
+            const __m256i used = _mm256_cmpgt_epi32(_mm256_set1_epi32(count - i), lanes);
+            const __m256 z = _mm256_maskload_ps(modZ + i, used);
+            const __m256i n = _mm256_maskload_epi32(iterations + i, used);
+
+            // log2(ln|z|) = ln(ln|z|) / ln(2)
+            const __m256 logLog = _mm256_mul_ps(log8(log8(z)), _mm256_set1_ps(1.44269504089f));
+            const __m256 smooth = _mm256_sub_ps(_mm256_add_ps(_mm256_cvtepi32_ps(n), _mm256_set1_ps(1.0f)), logLog);
+            _mm256_maskstore_ps(out + i, used, smooth);
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef _MANDELBROT_LIB_COLOR_SMOOTH_COLOR_KERNEL_H_
+#define _MANDELBROT_LIB_COLOR_SMOOTH_COLOR_KERNEL_H_
+
+#include "color/color.h"
+
+namespace mandelbrot
+{
+
+/**
+ * @brief Colors a run of pixels as \ref ColorStrategySmooth does, 8 pixels at a time. The logarithms are
+ *        approximated in single precision to within a few units in the last place, and the HSV colors are
+ *        converted without branches, which keeps each channel within one of the scalar strategy. The exceptions
+ *        are pixels whose saturation lies on the point where it wraps around from 1 to 0, which may come out on
+ *        the other side of it. Requires AVX2 and FMA.
+ * @param modZ Magnitude of z of each pixel
+ * @param modDz Magnitude of the scaled derivative of z of each pixel
+ * @param iterations Number of iterations of each pixel. Pixels with maxIterations or more are given inSet
+ * @param count Number of pixels
+ * @param maxIterations Maximum number of iterations before assuming that z is within the set
+ * @param colorIntensity Color intensity factor of the strategy
+ * @param inSet Color of the pixels within the set
+ * @param out Colors of the pixels
+ */
+void smoothColorsAVX2(const float *modZ, const float *modDz, const int *iterations, int count, int maxIterations,
+                      double colorIntensity, color_t inSet, color_t *out);
+
+/// Number of continuous iteration counts the strategies calculate at a time with \ref smoothIterationsAVX2(), on
+/// the stack
+constexpr int SmoothChunkSize = 256;
+
+/**
+ * @brief Calculates the continuous iteration count n + 1 - log2(ln|z|) of a run of pixels, 8 pixels at a time,
+ *        for the strategies that look it up in a \ref Palette. The logarithms are approximated in single precision,
+ *        as with \ref smoothColorsAVX2(). The counts of pixels within the set are undefined. Requires AVX2 and FMA.
+ * @param modZ Magnitude of z of each pixel
+ * @param iterations Number of iterations of each pixel
+ * @param count Number of pixels
+ * @param out Continuous iteration count of each pixel
+ */
+void smoothIterationsAVX2(const float *modZ, const int *iterations, int count, float *out);
+
+/// Returns true if the processor the program is running on supports the kernels of this file
+bool isSmoothColorKernelSupported();
+
+}
+
+#endif // _MANDELBROT_LIB_COLOR_SMOOTH_COLOR_KERNEL_H_
@@ -0,0 +1,24 @@
+#include "iteration-buffer.h"
+
+namespace mandelbrot
+{
+    IterationBuffer::IterationBuffer() :
+        m_width(0),
+        m_height(0),
+        m_iterations(),
+        m_modZ(),
+        m_modDz()
+    {
+    }
+
+    void IterationBuffer::resize(int width, int height)
+    {
+        m_width = width;
+        m_height = height;
+
+        const size_t numPixels = static_cast<size_t>(width) * static_cast<size_t>(height);
+        m_iterations.resize(numPixels);
+        m_modZ.resize(numPixels);
+        m_modDz.resize(numPixels);
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef _MANDELBROT_LIB_ITERATION_BUFFER_H_
+#define _MANDELBROT_LIB_ITERATION_BUFFER_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace mandelbrot
+{
+
+/**
+ * @class IterationBuffer
+ * @brief Escape time data of every pixel of a frame: the iteration count, and the magnitudes of z
+ *        and its derivative once z escaped. Kept apart from the colors of the frame, so that it can
+ *        be colored again without iterating a single pixel. Pixels are stored row by row.
+ */
+class IterationBuffer
+{
+public:
+    /// Constructs an empty buffer
+    IterationBuffer();
+
+    /// Resizes the buffer to hold width x height pixels. The contents are left unspecified
+    void resize(int width, int height);
+
+    /// Returns the width of the buffer, in pixels
+    int getWidth() const noexcept { return m_width; }
+
+    /// Returns the height of the buffer, in pixels
+    int getHeight() const noexcept { return m_height; }
+
+    /// Returns the index of the pixel at (x, y) into the arrays of the buffer
+    size_t indexOf(int x, int y) const noexcept { return static_cast<size_t>(y) * m_width + x; }
+
+    /// Returns the number of iterations taken by each pixel before z escaped
+    int *getIterations() noexcept { return m_iterations.data(); }
+    const int *getIterations() const noexcept { return m_iterations.data(); }
+
+    /// Returns the magnitude of z for each pixel, once it escaped
+    float *getModZ() noexcept { return m_modZ.data(); }
+    const float *getModZ() const noexcept { return m_modZ.data(); }
+
+    /// Returns the magnitude of the derivative of z for each pixel, multiplied by the scale of the frame
+    float *getModDz() noexcept { return m_modDz.data(); }
+    const float *getModDz() const noexcept { return m_modDz.data(); }
+
+private:
+    int m_width;
+
+    int m_height;
+
+    std::vector<int> m_iterations;
+
+    std::vector<float> m_modZ;
+
+    std::vector<float> m_modDz;
+};
+
+}
+
+#endif // _MANDELBROT_LIB_ITERATION_BUFFER_H_
@@ -0,0 +1,68 @@
+#include <algorithm>
+
+#include "iteration-histogram.h"
+
+namespace mandelbrot
+{
+    IterationHistogram::IterationHistogram() :
+        m_threadCounts(),
+        m_counts(),
+        m_cumulative(1, 0.0f),
+        m_total(0),
+        m_maxIterations(0)
+    {
+    }
+
+    void IterationHistogram::reset(int numThreads, int maxIterations)
+    {
+        m_maxIterations = std::max(maxIterations, 0);
+        m_threadCounts.resize(numThreads);
+        for (std::vector<uint32_t> &counts : m_threadCounts)
+            counts.assign(m_maxIterations, 0);
+        m_counts.resize(m_maxIterations);
+        m_total = 0;
+    }
+
+    void IterationHistogram::merge(int first, int last)
+    {
+        std::fill(m_counts.begin() + first, m_counts.begin() + last, 0);
+        for (const std::vector<uint32_t> &counts : m_threadCounts)
+        {
+            for (int n = first; n < last; ++n)
+                m_counts[n] += counts[n];
+        }
+    }
+
+    void IterationHistogram::finish()
+    {
+        m_total = 0;
+        for (const uint64_t count : m_counts)
+            m_total += count;
+
+        // Frames without escaped pixels have nothing to color, and are given an even distribution
+        m_cumulative.resize(m_maxIterations + 1);
+        uint64_t below = 0;
+        for (int n = 0; n <= m_maxIterations; ++n)
+        {
+            m_cumulative[n] = m_total > 0 ? static_cast<float>(static_cast<double>(below) / m_total)
+                                          : static_cast<float>(n) / std::max(m_maxIterations, 1);
+            if (n < m_maxIterations)
+                below += m_counts[n];
+        }
+    }
+
+    int IterationHistogram::getMaxIterations() const noexcept
+    {
+        return m_maxIterations;
+    }
+
+    uint64_t IterationHistogram::getTotal() const noexcept
+    {
+        return m_total;
+    }
+
+    const std::vector<float> &IterationHistogram::getCumulative() const noexcept
+    {
+        return m_cumulative;
+    }
+}
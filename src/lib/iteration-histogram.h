@@ -0,0 +1,69 @@
+#ifndef _MANDELBROT_LIB_ITERATION_HISTOGRAM_H_
+#define _MANDELBROT_LIB_ITERATION_HISTOGRAM_H_
+
+#include <cstdint>
+#include <vector>
+
+namespace mandelbrot
+{
+
+/**
+ * @class IterationHistogram
+ * @brief Distribution of the iteration counts of the escaped pixels of a frame. Each worker thread counts the
+ *        pixels it renders in a histogram of its own, without synchronization. The histograms are then summed
+ *        a range of iteration counts at a time, which the threads can do in parallel, and turned into the
+ *        cumulative distribution used by histogram coloring.
+ */
+class IterationHistogram
+{
+public:
+    /// Constructs an empty histogram
+    IterationHistogram();
+
+    /// Clears the histograms of the given number of threads, which count iterations below maxIterations
+    void reset(int numThreads, int maxIterations);
+
+    /// Counts the given iteration counts in the histogram of a thread. Counts of maxIterations or more are
+    /// those of pixels within the set, which are left out
+    void add(int thread, const int *iterations, int count)
+    {
+        uint32_t *counts = m_threadCounts[thread].data();
+        for (int i = 0; i < count; ++i)
+        {
+            if (iterations[i] < m_maxIterations)
+                ++counts[iterations[i]];
+        }
+    }
+
+    /// Sums the histograms of the threads for the iteration counts in [first, last). Disjoint ranges may be
+    /// summed concurrently
+    void merge(int first, int last);
+
+    /// Completes the cumulative distribution, once every range of iteration counts has been summed
+    void finish();
+
+    int getMaxIterations() const noexcept;
+
+    /// Returns the number of escaped pixels counted
+    uint64_t getTotal() const noexcept;
+
+    /// Returns the fraction of the escaped pixels that took fewer than n iterations, for n in [0, maxIterations]
+    const std::vector<float> &getCumulative() const noexcept;
+
+private:
+    /// Counts of each thread, indexed by the number of iterations
+    std::vector<std::vector<uint32_t>> m_threadCounts;
+
+    /// Counts of every thread together
+    std::vector<uint64_t> m_counts;
+
+    std::vector<float> m_cumulative;
+
+    uint64_t m_total;
+
+    int m_maxIterations;
+};
+
+}
+
+#endif // _MANDELBROT_LIB_ITERATION_HISTOGRAM_H_
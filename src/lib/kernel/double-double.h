@@ -0,0 +1,97 @@
+#ifndef _MANDELBROT_LIB_KERNEL_DOUBLE_DOUBLE_H_
+#define _MANDELBROT_LIB_KERNEL_DOUBLE_DOUBLE_H_
+
+#include <cmath>
+
+namespace mandelbrot
+{
+
+/**
+ * @struct DoubleDouble
+ * @brief Unevaluated sum of two doubles, hi + lo with |lo| <= ulp(hi) / 2, giving about 106 bits
+ *        of precision at a fraction of the cost of MPFR. Relies on IEEE 754 rounding: the code
+ *        using it must not be compiled with -ffast-math.
+ */
+struct DoubleDouble
+{
+    double hi;
+    double lo;
+
+    constexpr DoubleDouble() : hi(0.0), lo(0.0) {}
+    constexpr DoubleDouble(double h) : hi(h), lo(0.0) {}
+    constexpr DoubleDouble(double h, double l) : hi(h), lo(l) {}
+
+    explicit operator double() const { return hi + lo; }
+};
+
+/// Sum of two doubles, with the rounding error of the sum in lo. Requires |a| >= |b|
+inline DoubleDouble quickTwoSum(double a, double b)
+{
+    const double s = a + b;
+    return DoubleDouble(s, b - (s - a));
+}
+
+/// Sum of two doubles, with the rounding error of the sum in lo
+inline DoubleDouble twoSum(double a, double b)
+{
+    const double s = a + b;
+    const double bb = s - a;
+    return DoubleDouble(s, (a - (s - bb)) + (b - bb));
+}
+
+#if !defined(__FMA__) && !defined(FP_FAST_FMA)
+/// Veltkamp's split of a double into two halves of 26 bits, hi + lo, whose products with each other are exact.
+/// Overflows for |a| beyond about 2^996
+inline DoubleDouble split(double a)
+{
+    const double t = 134217729.0 * a; // 2^27 + 1
+    const double hi = t - (t - a);
+    return DoubleDouble(hi, a - hi);
+}
+#endif
+
+/// Product of two doubles, with the rounding error of the product in lo. Without a fused multiply-add
+/// instruction, std::fma would be a call into a software implementation, so the error is found with
+/// Dekker's algorithm instead
+inline DoubleDouble twoProduct(double a, double b)
+{
+    const double p = a * b;
+#if defined(__FMA__) || defined(FP_FAST_FMA)
+    return DoubleDouble(p, std::fma(a, b, -p));
+#else
+    const DoubleDouble as = split(a);
+    const DoubleDouble bs = split(b);
+    return DoubleDouble(p, ((as.hi * bs.hi - p) + as.hi * bs.lo + as.lo * bs.hi) + as.lo * bs.lo);
+#endif
+}
+
+inline DoubleDouble operator+(const DoubleDouble &a, const DoubleDouble &b)
+{
+    DoubleDouble s = twoSum(a.hi, b.hi);
+    const DoubleDouble t = twoSum(a.lo, b.lo);
+    s.lo += t.hi;
+    s = quickTwoSum(s.hi, s.lo);
+    s.lo += t.lo;
+    return quickTwoSum(s.hi, s.lo);
+}
+
+inline DoubleDouble operator-(const DoubleDouble &a)
+{
+    return DoubleDouble(-a.hi, -a.lo);
+}
+
+inline DoubleDouble operator-(const DoubleDouble &a, const DoubleDouble &b)
+{
+    return a + -b;
+}
+
+inline DoubleDouble operator*(const DoubleDouble &a, const DoubleDouble &b)
+{
+    DoubleDouble p = twoProduct(a.hi, b.hi);
+    p.lo += a.hi * b.lo + a.lo * b.hi;
+    return quickTwoSum(p.hi, p.lo);
+}
+
+}
+
+#endif // _MANDELBROT_LIB_KERNEL_DOUBLE_DOUBLE_H_
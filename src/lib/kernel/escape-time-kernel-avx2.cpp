@@ -0,0 +1,187 @@
+#include <immintrin.h>
+
+#include "kernel/escape-time-kernel.h"
+
+// This translation unit is compiled with -mavx2 -mfma. Avoid including any headers with inline
+// functions (such as the standard library), as the linker may otherwise pick the AVX2 variant
+// of those functions for use in code paths that are meant to run on any processor.
+
+namespace mandelbrot
+{
+    // The operations are local to this translation unit, which has its own instruction set
+    namespace
+    {
+        /// Operations on a vector of 4 doubles
+        struct DoubleLanes
+        {
+            typedef double Real;
+            typedef __m256d Vec;
+            static constexpr int Count = 4;
+
+            static Vec set1(Real x) { return _mm256_set1_pd(x); }
+            static Vec load(const Real *p) { return _mm256_load_pd(p); }
+            static void store(Real *p, Vec v) { _mm256_store_pd(p, v); }
+            static Vec add(Vec a, Vec b) { return _mm256_add_pd(a, b); }
+            static Vec sub(Vec a, Vec b) { return _mm256_sub_pd(a, b); }
+            static Vec mul(Vec a, Vec b) { return _mm256_mul_pd(a, b); }
+            static Vec fmadd(Vec a, Vec b, Vec c) { return _mm256_fmadd_pd(a, b, c); }
+            static Vec fmsub(Vec a, Vec b, Vec c) { return _mm256_fmsub_pd(a, b, c); }
+            static Vec blend(Vec a, Vec b, Vec mask) { return _mm256_blendv_pd(a, b, mask); }
+            static Vec bitAnd(Vec a, Vec b) { return _mm256_and_pd(a, b); }
+            static Vec bitAndNot(Vec a, Vec b) { return _mm256_andnot_pd(a, b); }
+            static Vec bitOr(Vec a, Vec b) { return _mm256_or_pd(a, b); }
+            static Vec greater(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+            static Vec less(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+            static Vec equal(Vec a, Vec b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+            static int moveMask(Vec v) { return _mm256_movemask_pd(v); }
+            static void storeIterations(int *p, Vec v) { _mm_store_si128(reinterpret_cast<__m128i*>(p), _mm256_cvtpd_epi32(v)); }
+        };
+
+        /// Operations on a vector of 8 floats
+        struct FloatLanes
+        {
+            typedef float Real;
+            typedef __m256 Vec;
+            static constexpr int Count = 8;
+
+            static Vec set1(Real x) { return _mm256_set1_ps(x); }
+            static Vec load(const Real *p) { return _mm256_load_ps(p); }
+            static void store(Real *p, Vec v) { _mm256_store_ps(p, v); }
+            static Vec add(Vec a, Vec b) { return _mm256_add_ps(a, b); }
+            static Vec sub(Vec a, Vec b) { return _mm256_sub_ps(a, b); }
+            static Vec mul(Vec a, Vec b) { return _mm256_mul_ps(a, b); }
+            static Vec fmadd(Vec a, Vec b, Vec c) { return _mm256_fmadd_ps(a, b, c); }
+            static Vec fmsub(Vec a, Vec b, Vec c) { return _mm256_fmsub_ps(a, b, c); }
+            static Vec blend(Vec a, Vec b, Vec mask) { return _mm256_blendv_ps(a, b, mask); }
+            static Vec bitAnd(Vec a, Vec b) { return _mm256_and_ps(a, b); }
+            static Vec bitAndNot(Vec a, Vec b) { return _mm256_andnot_ps(a, b); }
+            static Vec bitOr(Vec a, Vec b) { return _mm256_or_ps(a, b); }
+            static Vec greater(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+            static Vec less(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+            static Vec equal(Vec a, Vec b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+            static int moveMask(Vec v) { return _mm256_movemask_ps(v); }
+            static void storeIterations(int *p, Vec v) { _mm256_store_si256(reinterpret_cast<__m256i*>(p), _mm256_cvtps_epi32(v)); }
+        };
+    }
+
+    /// Iterates the points a vector of the width given by Lanes at a time. Points are given and returned as doubles,
+    /// whatever the precision they are iterated in
+    template <typename Lanes>
+    static uint64_t escapeTime(const double *cRe, const double *cIm, int count, int maxIterations, double tolerance, EscapeTimeRow &out)
+    {
+        typedef typename Lanes::Real Real;
+        typedef typename Lanes::Vec Vec;
+        constexpr int LaneCount = Lanes::Count;
+
+        const Vec zero = Lanes::set1(Real(0.0));
+        const Vec one = Lanes::set1(Real(1.0));
+        const Vec two = Lanes::set1(Real(2.0));
+        const Vec limit = Lanes::set1(Real(4.0));
+        const Vec allLanes = Lanes::equal(zero, zero);
+        const Vec signMask = Lanes::set1(Real(-0.0));
+        const Vec periodTolerance = Lanes::set1(static_cast<Real>(tolerance));
+        uint64_t skippedIterations = 0;
+
+        alignas(32) Real cReBuf[LaneCount], cImBuf[LaneCount];
+        alignas(32) Real zReBuf[LaneCount], zImBuf[LaneCount], dzReBuf[LaneCount], dzImBuf[LaneCount];
+        alignas(32) int iterBuf[LaneCount];
+
+        for (int i = 0; i < count; i += LaneCount)
+        {
+            // Unused lanes of a partial vector are given a point that escapes on the first iteration
+            const int numLanes = count - i < LaneCount ? count - i : LaneCount;
+            for (int lane = 0; lane < LaneCount; ++lane)
+            {
+                cReBuf[lane] = lane < numLanes ? static_cast<Real>(cRe[i + lane]) : Real(4.0);
+                cImBuf[lane] = lane < numLanes ? static_cast<Real>(cIm[i + lane]) : Real(0.0);
+            }
+
+            const Vec cr = Lanes::load(cReBuf);
+            const Vec ci = Lanes::load(cImBuf);
+
+            Vec zr = zero, zi = zero, zr2 = zero, zi2 = zero,
+                dzr = zero, dzi = zero,
+                iters = zero,
+                active = allLanes,
+                periodic = zero,
+                savedZr = zero, savedZi = zero;
+            unsigned savePeriod = 1, sinceSave = 0;
+
+            for (int n = 0; n < maxIterations; ++n)
+            {
+                // Derivative of z: dz = 2 * z * dz + 1
+                const Vec nextDzr = Lanes::fmadd(two, Lanes::fmsub(zr, dzr, Lanes::mul(zi, dzi)), one);
+                const Vec nextDzi = Lanes::mul(two, Lanes::fmadd(zr, dzi, Lanes::mul(zi, dzr)));
+
+                // z = z^2 + c
+                const Vec nextZr = Lanes::add(Lanes::sub(zr2, zi2), cr);
+                const Vec nextZi = Lanes::fmadd(Lanes::add(zr, zr), zi, ci);
+
+                // Lanes that have already escaped keep their final values
+                dzr = Lanes::blend(dzr, nextDzr, active);
+                dzi = Lanes::blend(dzi, nextDzi, active);
+                zr = Lanes::blend(zr, nextZr, active);
+                zi = Lanes::blend(zi, nextZi, active);
+                iters = Lanes::add(iters, Lanes::bitAnd(active, one));
+
+                zr2 = Lanes::mul(zr, zr);
+                zi2 = Lanes::mul(zi, zi);
+
+                const Vec escaped = Lanes::greater(Lanes::add(zr2, zi2), limit);
+                active = Lanes::bitAndNot(escaped, active);
+
+                // Brent's cycle detection: lanes that returned to the saved value of z are within the set
+                const Vec nearRe = Lanes::less(Lanes::bitAndNot(signMask, Lanes::sub(zr, savedZr)), periodTolerance);
+                const Vec nearIm = Lanes::less(Lanes::bitAndNot(signMask, Lanes::sub(zi, savedZi)), periodTolerance);
+                const Vec cycled = Lanes::bitAnd(active, Lanes::bitAnd(nearRe, nearIm));
+                periodic = Lanes::bitOr(periodic, cycled);
+                active = Lanes::bitAndNot(cycled, active);
+
+                if (Lanes::moveMask(active) == 0)
+                    break;
+
+                if (++sinceSave == savePeriod)
+                {
+                    savedZr = zr;
+                    savedZi = zi;
+                    savePeriod *= 2;
+                    sinceSave = 0;
+                }
+            }
+
+            Lanes::store(zReBuf, zr);
+            Lanes::store(zImBuf, zi);
+            Lanes::store(dzReBuf, dzr);
+            Lanes::store(dzImBuf, dzi);
+            Lanes::storeIterations(iterBuf, iters);
+            const int periodicLanes = Lanes::moveMask(periodic);
+
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                out.zRe[i + lane] = zReBuf[lane];
+                out.zIm[i + lane] = zImBuf[lane];
+                out.dzRe[i + lane] = dzReBuf[lane];
+                out.dzIm[i + lane] = dzImBuf[lane];
+                out.iterations[i + lane] = iterBuf[lane];
+
+                if (periodicLanes & (1 << lane))
+                {
+                    skippedIterations += static_cast<uint64_t>(maxIterations - iterBuf[lane]);
+                    out.iterations[i + lane] = maxIterations;
+                }
+            }
+        }
+
+        return skippedIterations;
+    }
+
+    uint64_t escapeTimeAVX2(const double *cRe, const double *cIm, int count, int maxIterations, double tolerance, EscapeTimeRow &out)
+    {
+        return escapeTime<DoubleLanes>(cRe, cIm, count, maxIterations, tolerance, out);
+    }
+
+    uint64_t escapeTimeFloatAVX2(const double *cRe, const double *cIm, int count, int maxIterations, double tolerance, EscapeTimeRow &out)
+    {
+        return escapeTime<FloatLanes>(cRe, cIm, count, maxIterations, tolerance, out);
+    }
+}
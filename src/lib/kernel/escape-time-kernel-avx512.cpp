@@ -0,0 +1,188 @@
+#include <immintrin.h>
+
+#include "kernel/escape-time-kernel.h"
+
+// This translation unit is compiled with -mavx512f. See escape-time-kernel-avx2.cpp
+// regarding the inclusion of other headers.
+
+namespace mandelbrot
+{
+    // The operations are local to this translation unit, which has its own instruction set
+    namespace
+    {
+        /// Operations on a vector of 8 doubles
+        struct DoubleLanes
+        {
+            typedef double Real;
+            typedef __m512d Vec;
+            typedef __mmask8 Mask;
+            static constexpr int Count = 8;
+
+            static Vec set1(Real x) { return _mm512_set1_pd(x); }
+            static Vec add(Vec a, Vec b) { return _mm512_add_pd(a, b); }
+            static Vec sub(Vec a, Vec b) { return _mm512_sub_pd(a, b); }
+            static Vec mul(Vec a, Vec b) { return _mm512_mul_pd(a, b); }
+            static Vec fmadd(Vec a, Vec b, Vec c) { return _mm512_fmadd_pd(a, b, c); }
+            static Vec fmsub(Vec a, Vec b, Vec c) { return _mm512_fmsub_pd(a, b, c); }
+            static Vec abs(Vec a) { return _mm512_abs_pd(a); }
+            static Vec blend(Mask mask, Vec a, Vec b) { return _mm512_mask_blend_pd(mask, a, b); }
+            static Vec maskAdd(Vec src, Mask mask, Vec a, Vec b) { return _mm512_mask_add_pd(src, mask, a, b); }
+            static Mask greater(Vec a, Vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+            static Mask less(Vec a, Vec b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+
+            static Vec load(const double *p, Mask mask) { return _mm512_maskz_loadu_pd(mask, p); }
+            static void store(double *p, Mask mask, Vec v) { _mm512_mask_storeu_pd(p, mask, v); }
+            static void storeAligned(Real *p, Vec v) { _mm512_store_pd(p, v); }
+        };
+
+        /// Operations on a vector of 16 floats. Points are converted from and to doubles on the way in and out
+        struct FloatLanes
+        {
+            typedef float Real;
+            typedef __m512 Vec;
+            typedef __mmask16 Mask;
+            static constexpr int Count = 16;
+
+            static Vec set1(Real x) { return _mm512_set1_ps(x); }
+            static Vec add(Vec a, Vec b) { return _mm512_add_ps(a, b); }
+            static Vec sub(Vec a, Vec b) { return _mm512_sub_ps(a, b); }
+            static Vec mul(Vec a, Vec b) { return _mm512_mul_ps(a, b); }
+            static Vec fmadd(Vec a, Vec b, Vec c) { return _mm512_fmadd_ps(a, b, c); }
+            static Vec fmsub(Vec a, Vec b, Vec c) { return _mm512_fmsub_ps(a, b, c); }
+            static Vec abs(Vec a) { return _mm512_abs_ps(a); }
+            static Vec blend(Mask mask, Vec a, Vec b) { return _mm512_mask_blend_ps(mask, a, b); }
+            static Vec maskAdd(Vec src, Mask mask, Vec a, Vec b) { return _mm512_mask_add_ps(src, mask, a, b); }
+            static Mask greater(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+            static Mask less(Vec a, Vec b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+
+            static Vec load(const double *p, Mask mask)
+            {
+                alignas(64) float buf[Count];
+                for (int lane = 0; lane < Count; ++lane)
+                    buf[lane] = (mask >> lane) & 1 ? static_cast<float>(p[lane]) : 0.0f;
+                return _mm512_load_ps(buf);
+            }
+
+            static void store(double *p, Mask mask, Vec v)
+            {
+                alignas(64) float buf[Count];
+                _mm512_store_ps(buf, v);
+                for (int lane = 0; lane < Count; ++lane)
+                {
+                    if ((mask >> lane) & 1)
+                        p[lane] = buf[lane];
+                }
+            }
+
+            static void storeAligned(Real *p, Vec v) { _mm512_store_ps(p, v); }
+        };
+    }
+
+    /// Iterates the points a vector of the width given by Lanes at a time. Points are given and returned as doubles,
+    /// whatever the precision they are iterated in
+    template <typename Lanes>
+    static uint64_t escapeTime(const double *cRe, const double *cIm, int count, int maxIterations, double tolerance, EscapeTimeRow &out)
+    {
+        typedef typename Lanes::Real Real;
+        typedef typename Lanes::Vec Vec;
+        typedef typename Lanes::Mask Mask;
+        constexpr int LaneCount = Lanes::Count;
+
+        const Vec zero = Lanes::set1(Real(0.0));
+        const Vec one = Lanes::set1(Real(1.0));
+        const Vec two = Lanes::set1(Real(2.0));
+        const Vec limit = Lanes::set1(Real(4.0));
+        const Vec periodTolerance = Lanes::set1(static_cast<Real>(tolerance));
+        uint64_t skippedIterations = 0;
+
+        alignas(64) Real iterBuf[LaneCount];
+
+        for (int i = 0; i < count; i += LaneCount)
+        {
+            // Partial vectors at the end of the row are handled by masking off the unused lanes
+            const int numLanes = count - i < LaneCount ? count - i : LaneCount;
+            const Mask usedLanes = static_cast<Mask>((1u << numLanes) - 1u);
+
+            const Vec cr = Lanes::load(cRe + i, usedLanes);
+            const Vec ci = Lanes::load(cIm + i, usedLanes);
+
+            Vec zr = zero, zi = zero, zr2 = zero, zi2 = zero,
+                dzr = zero, dzi = zero,
+                iters = zero,
+                savedZr = zero, savedZi = zero;
+            Mask active = usedLanes,
+                 periodic = 0;
+            unsigned savePeriod = 1, sinceSave = 0;
+
+            for (int n = 0; n < maxIterations; ++n)
+            {
+                // Derivative of z: dz = 2 * z * dz + 1
+                const Vec nextDzr = Lanes::fmadd(two, Lanes::fmsub(zr, dzr, Lanes::mul(zi, dzi)), one);
+                const Vec nextDzi = Lanes::mul(two, Lanes::fmadd(zr, dzi, Lanes::mul(zi, dzr)));
+
+                // z = z^2 + c
+                const Vec nextZr = Lanes::add(Lanes::sub(zr2, zi2), cr);
+                const Vec nextZi = Lanes::fmadd(Lanes::add(zr, zr), zi, ci);
+
+                // Lanes that have already escaped keep their final values
+                dzr = Lanes::blend(active, dzr, nextDzr);
+                dzi = Lanes::blend(active, dzi, nextDzi);
+                zr = Lanes::blend(active, zr, nextZr);
+                zi = Lanes::blend(active, zi, nextZi);
+                iters = Lanes::maskAdd(iters, active, iters, one);
+
+                zr2 = Lanes::mul(zr, zr);
+                zi2 = Lanes::mul(zi, zi);
+
+                const Mask escaped = Lanes::greater(Lanes::add(zr2, zi2), limit);
+                active = static_cast<Mask>(active & ~escaped);
+
+                // Brent's cycle detection: lanes that returned to the saved value of z are within the set
+                const Mask nearRe = Lanes::less(Lanes::abs(Lanes::sub(zr, savedZr)), periodTolerance);
+                const Mask nearIm = Lanes::less(Lanes::abs(Lanes::sub(zi, savedZi)), periodTolerance);
+                const Mask cycled = static_cast<Mask>(active & nearRe & nearIm);
+                periodic = static_cast<Mask>(periodic | cycled);
+                active = static_cast<Mask>(active & ~cycled);
+
+                if (active == 0)
+                    break;
+
+                if (++sinceSave == savePeriod)
+                {
+                    savedZr = zr;
+                    savedZi = zi;
+                    savePeriod *= 2;
+                    sinceSave = 0;
+                }
+            }
+
+            Lanes::store(out.zRe + i, usedLanes, zr);
+            Lanes::store(out.zIm + i, usedLanes, zi);
+            Lanes::store(out.dzRe + i, usedLanes, dzr);
+            Lanes::store(out.dzIm + i, usedLanes, dzi);
+            Lanes::storeAligned(iterBuf, iters);
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                out.iterations[i + lane] = static_cast<int>(iterBuf[lane]);
+
+                if (periodic & (1u << lane))
+                {
+                    skippedIterations += static_cast<uint64_t>(maxIterations - out.iterations[i + lane]);
+                    out.iterations[i + lane] = maxIterations;
+                }
+            }
+        }
+
+        return skippedIterations;
+    }
+
+    uint64_t escapeTimeAVX512(const double *cRe, const double *cIm, int count, int maxIterations, double tolerance, EscapeTimeRow &out)
+    {
+        return escapeTime<DoubleLanes>(cRe, cIm, count, maxIterations, tolerance, out);
+    }
+
+    uint64_t escapeTimeFloatAVX512(const double *cRe, const double *cIm, int count, int maxIterations, double tolerance, EscapeTimeRow &out)
+    {
+        return escapeTime<FloatLanes>(cRe, cIm, count, maxIterations, tolerance, out);
+    }
+}
@@ -0,0 +1,151 @@
+#include "kernel/escape-time-kernel.h"
+#include "kernel/double-double.h"
+#include "kernel/precision.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace mandelbrot
+{
+    /**
+     * @brief Iterates one point at a time in the arithmetic given by Real, which may be narrower or wider than the
+     *        coordinates given by Coord. The derivative is iterated in Real as well, except for double-doubles,
+     *        whose derivative only needs the range of a double rather than its precision.
+     */
+    template <typename Real, typename Coord>
+    static uint64_t escapeTime(const Coord *cRe, const Coord *cIm, int count, int maxIterations, double tolerance, EscapeTimeRow &out)
+    {
+        using Derivative = typename std::conditional<std::is_same<Real, DoubleDouble>::value, double, Real>::type;
+        constexpr double Limit = 4.0;
+        uint64_t skippedIterations = 0;
+
+        for (int i = 0; i < count; ++i)
+        {
+            const Real cR = static_cast<Real>(cRe[i]);
+            const Real cI = static_cast<Real>(cIm[i]);
+
+            Real zRe = Real(0.0),
+                 zIm = Real(0.0),
+                 zRe2 = Real(0.0),
+                 zIm2 = Real(0.0),
+                 zTemp = Real(0.0);
+            Derivative dzRe = Derivative(0.0),
+                       dzIm = Derivative(0.0),
+                       dzTemp = Derivative(0.0);
+            Real savedRe = Real(0.0),
+                 savedIm = Real(0.0);
+            int numIterations = 0;
+            unsigned savePeriod = 1,
+                     sinceSave = 0;
+            do
+            {
+                ++numIterations;
+
+                // Derivative of z
+                const Derivative zR = static_cast<Derivative>(zRe), zI = static_cast<Derivative>(zIm);
+                dzTemp = Derivative(2.0) * (zR * dzRe - dzIm * zI) + Derivative(1.0);
+                dzIm = Derivative(2.0) * (zI * dzRe + zR * dzIm);
+                dzRe = dzTemp;
+
+                zTemp = zRe + zIm;
+                zIm = (zTemp * zTemp) - zRe2 - zIm2;
+                zIm = zIm + cI;
+                zRe = zRe2 - zIm2 + cR;
+                zRe2 = zRe * zRe;
+                zIm2 = zIm * zIm;
+
+                if (static_cast<double>(zRe2 + zIm2) > Limit)
+                    break;
+
+                if (std::fabs(static_cast<double>(zRe - savedRe)) < tolerance && std::fabs(static_cast<double>(zIm - savedIm)) < tolerance)
+                {
+                    skippedIterations += static_cast<uint64_t>(maxIterations - numIterations);
+                    numIterations = maxIterations;
+                    break;
+                }
+
+                if (++sinceSave == savePeriod)
+                {
+                    savedRe = zRe;
+                    savedIm = zIm;
+                    savePeriod *= 2;
+                    sinceSave = 0;
+                }
+
+            } while (numIterations < maxIterations);
+
+            out.zRe[i] = static_cast<double>(zRe);
+            out.zIm[i] = static_cast<double>(zIm);
+            out.dzRe[i] = static_cast<double>(dzRe);
+            out.dzIm[i] = static_cast<double>(dzIm);
+            out.iterations[i] = numIterations;
+        }
+
+        return skippedIterations;
+    }
+
+    uint64_t escapeTimeScalar(const double *cRe, const double *cIm, int count, int maxIterations, double tolerance, EscapeTimeRow &out)
+    {
+        return escapeTime<double>(cRe, cIm, count, maxIterations, tolerance, out);
+    }
+
+    uint64_t escapeTimeFloatScalar(const double *cRe, const double *cIm, int count, int maxIterations, double tolerance, EscapeTimeRow &out)
+    {
+        return escapeTime<float>(cRe, cIm, count, maxIterations, tolerance, out);
+    }
+
+    uint64_t escapeTimeDoubleDouble(const DoubleDouble *cRe, const DoubleDouble *cIm, int count, int maxIterations,
+                                    double tolerance, EscapeTimeRow &out)
+    {
+        return escapeTime<DoubleDouble>(cRe, cIm, count, maxIterations, tolerance, out);
+    }
+
+    double getPeriodicityTolerance(Precision precision, double scale)
+    {
+        const double limit = precision == Precision::Float ? FloatPeriodicityTolerance : PeriodicityTolerance;
+        return std::min(limit, scale * 1e-3);
+    }
+
+    bool isInMainCardioidOrBulb(double cRe, double cIm)
+    {
+        const double cIm2 = cIm * cIm;
+
+        // Main cardioid
+        const double x = cRe - 0.25;
+        const double q = x * x + cIm2;
+        if (q * (q + x) <= 0.25 * cIm2)
+            return true;
+
+        // Period-2 bulb, the disc of radius 1/4 around -1
+        const double x2 = cRe + 1.0;
+        return x2 * x2 + cIm2 <= 0.0625;
+    }
+
+    bool isInMainCardioidOrBulb(const DoubleDouble &cRe, const DoubleDouble &cIm)
+    {
+        // The sums are normalized, so the sign of each difference is that of its leading double
+        const DoubleDouble cIm2 = cIm * cIm;
+
+        const DoubleDouble x = cRe - DoubleDouble(0.25);
+        const DoubleDouble q = x * x + cIm2;
+        if ((q * (q + x) - DoubleDouble(0.25) * cIm2).hi <= 0.0)
+            return true;
+
+        const DoubleDouble x2 = cRe + DoubleDouble(1.0);
+        return (x2 * x2 + cIm2 - DoubleDouble(0.0625)).hi <= 0.0;
+    }
+
+    EscapeTimeKernel selectEscapeTimeKernel(Precision precision)
+    {
+        const bool single = precision == Precision::Float;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return single ? &escapeTimeFloatAVX512 : &escapeTimeAVX512;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return single ? &escapeTimeFloatAVX2 : &escapeTimeAVX2;
+#endif
+        return single ? &escapeTimeFloatScalar : &escapeTimeScalar;
+    }
+}
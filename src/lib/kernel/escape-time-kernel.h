@@ -0,0 +1,105 @@
+#ifndef _MANDELBROT_LIB_KERNEL_ESCAPE_TIME_KERNEL_H_
+#define _MANDELBROT_LIB_KERNEL_ESCAPE_TIME_KERNEL_H_
+
+#include <cstdint>
+
+namespace mandelbrot
+{
+
+// Only declared here, as the vectorized kernels that include this header must not see the inline functions
+// of their headers
+struct DoubleDouble;
+enum class Precision;
+
+/**
+ * @struct EscapeTimeRow
+ * @brief Output of an escape-time kernel, stored as a structure of arrays. Each array
+ *        must have room for at least as many elements as there are points being iterated.
+ */
+struct EscapeTimeRow
+{
+    /// Real portion of z at the iteration in which it escaped (or at max iterations)
+    double *zRe;
+
+    /// Imaginary portion of z
+    double *zIm;
+
+    /// Real portion of the derivative of z
+    double *dzRe;
+
+    /// Imaginary portion of the derivative of z
+    double *dzIm;
+
+    /// Number of iterations taken before z breached the escape radius
+    int *iterations;
+};
+
+/// Orbits that return within this distance of a previously saved point are considered periodic. Frames whose
+/// pixels are closer together than a thousand times this use a thousandth of the distance between their pixels
+/// instead, see \ref getPeriodicityTolerance()
+constexpr double PeriodicityTolerance = 1e-13;
+
+/// Periodicity tolerance of the single precision kernels, a few units in the last place of a float of magnitude 1
+constexpr float FloatPeriodicityTolerance = 1e-6f;
+
+/// Returns the periodicity tolerance of the kernels of the given precision for a frame with the given distance
+/// between its pixels. The tolerance shrinks along with the pixels, so that the orbits of exterior points that
+/// linger near a cycle are not taken to be periodic, whatever the precision they are iterated in
+double getPeriodicityTolerance(Precision precision, double scale);
+
+/**
+ * @brief Iterates the function z -> z^2 + c for a batch of points, such as the pixels of a row
+ *        or the border of a rectangle. Orbits are checked for cycles with Brent's algorithm: z is
+ *        saved at every power of two iterations, and a point whose orbit returns to the saved value
+ *        is within the set, and stops iterating early.
+ * @param cRe Real components of each point c
+ * @param cIm Imaginary components of each point c
+ * @param count Number of points to iterate
+ * @param maxIterations Maximum number of iterations before assuming a point is within the set
+ * @param tolerance Periodicity tolerance, see \ref getPeriodicityTolerance()
+ * @param out Destination of the final z, dz and iteration count of each point. Points found to be
+ *            periodic are given maxIterations
+ * @return Number of iterations skipped by the periodicity check, summed over every point
+ */
+using EscapeTimeKernel = uint64_t (*)(const double *cRe, const double *cIm, int count, int maxIterations, double tolerance, EscapeTimeRow &out);
+
+/// Portable kernel, iterating one point at a time
+uint64_t escapeTimeScalar(const double *cRe, const double *cIm, int count, int maxIterations, double tolerance, EscapeTimeRow &out);
+
+/// Kernel iterating 4 points at a time. Requires AVX2 and FMA
+uint64_t escapeTimeAVX2(const double *cRe, const double *cIm, int count, int maxIterations, double tolerance, EscapeTimeRow &out);
+
+/// Kernel iterating 8 points at a time. Requires AVX-512F
+uint64_t escapeTimeAVX512(const double *cRe, const double *cIm, int count, int maxIterations, double tolerance, EscapeTimeRow &out);
+
+/// Portable kernel, iterating one point at a time in single precision
+uint64_t escapeTimeFloatScalar(const double *cRe, const double *cIm, int count, int maxIterations, double tolerance, EscapeTimeRow &out);
+
+/// Kernel iterating 8 points at a time in single precision. Requires AVX2 and FMA
+uint64_t escapeTimeFloatAVX2(const double *cRe, const double *cIm, int count, int maxIterations, double tolerance, EscapeTimeRow &out);
+
+/// Kernel iterating 16 points at a time in single precision. Requires AVX-512F
+uint64_t escapeTimeFloatAVX512(const double *cRe, const double *cIm, int count, int maxIterations, double tolerance, EscapeTimeRow &out);
+
+/**
+ * @brief Iterates a batch of points given in double-double precision, as the other kernels do
+ * @param tolerance Periodicity tolerance, see \ref getPeriodicityTolerance()
+ */
+uint64_t escapeTimeDoubleDouble(const DoubleDouble *cRe, const DoubleDouble *cIm, int count, int maxIterations,
+                                double tolerance, EscapeTimeRow &out);
+
+/// Returns true if c lies within the main cardioid or the period-2 bulb of the set, which together
+/// make up most of its area. Such points never escape, so they need not be iterated at all
+bool isInMainCardioidOrBulb(double cRe, double cIm);
+
+/// As above, for points given in double-double precision, whose offsets from the boundary of the cardioid
+/// or the bulb may be far smaller than the rounding of a double
+bool isInMainCardioidOrBulb(const DoubleDouble &cRe, const DoubleDouble &cIm);
+
+/// Returns the widest kernel of the given precision, \ref Precision::Float or \ref Precision::Double, that is
+/// supported by the processor the program is running on
+EscapeTimeKernel selectEscapeTimeKernel(Precision precision);
+
+}
+
+#endif // _MANDELBROT_LIB_KERNEL_ESCAPE_TIME_KERNEL_H_
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "kernel/float-exp.h"
+
+namespace mandelbrot
+{
+    FloatExp::FloatExp() :
+        m_mantissa(0.0),
+        m_exponent(0)
+    {
+    }
+
+    FloatExp::FloatExp(double value) :
+        m_mantissa(value),
+        m_exponent(0)
+    {
+        normalize();
+    }
+
+    FloatExp::FloatExp(double mantissa, long exponent) :
+        m_mantissa(mantissa),
+        m_exponent(exponent)
+    {
+        normalize();
+    }
+
+    FloatExp FloatExp::fromString(const std::string &str)
+    {
+        mpfr_t value;
+        mpfr_init2(value, 64);
+        const bool valid = mpfr_set_str(value, str.c_str(), 10, MPFR_RNDN) == 0 && mpfr_number_p(value);
+
+        long exponent = 0;
+        const double mantissa = valid ? mpfr_get_d_2exp(&exponent, value, MPFR_RNDN) : 0.0;
+        mpfr_clear(value);
+
+        if (!valid)
+            throw std::invalid_argument("Not a number: " + str);
+
+        return FloatExp(mantissa, exponent);
+    }
+
+    FloatExp FloatExp::exp2(double x)
+    {
+        const double whole = std::floor(x);
+        return FloatExp(std::exp2(x - whole), static_cast<long>(whole));
+    }
+
+    std::string FloatExp::toString(int digits) const
+    {
+        if (m_mantissa == 0.0)
+            return "0";
+
+        mpfr_t value;
+        mpfr_init2(value, 64);
+        toMpfr(value);
+
+        mpfr_exp_t exponent = 0;
+        char *str = mpfr_get_str(nullptr, &exponent, 10, static_cast<size_t>(std::max(digits, 1)), value, MPFR_RNDN);
+        std::string mantissa { str };
+        mpfr_free_str(str);
+        mpfr_clear(value);
+
+        // The digits are those of 0.ddd * 10^exponent, and are written as d.dd * 10^(exponent - 1)
+        const size_t first = mantissa[0] == '-' ? 1 : 0;
+        const size_t last = mantissa.find_last_not_of('0');
+        mantissa.erase(last + 1);
+        if (mantissa.size() > first + 1)
+            mantissa.insert(first + 1, ".");
+
+        return mantissa + "e" + std::to_string(exponent - 1);
+    }
+
+    double FloatExp::toDouble() const
+    {
+        // ldexp takes an int, which the exponent is clamped to well beyond the range of a double
+        const long exponent = m_exponent < -4096 ? -4096 : (m_exponent > 4096 ? 4096 : m_exponent);
+        return std::ldexp(m_mantissa, static_cast<int>(exponent));
+    }
+
+    double FloatExp::log2() const
+    {
+        return std::log2(std::fabs(m_mantissa)) + static_cast<double>(m_exponent);
+    }
+
+    double FloatExp::getMantissa() const noexcept
+    {
+        return m_mantissa;
+    }
+
+    long FloatExp::getExponent() const noexcept
+    {
+        return m_exponent;
+    }
+
+    void FloatExp::toMpfr(mpfr_ptr out) const
+    {
+        mpfr_set_d(out, m_mantissa, MPFR_RNDN);
+        mpfr_mul_2si(out, out, m_exponent, MPFR_RNDN);
+    }
+
+    FloatExp FloatExp::operator*(const FloatExp &other) const
+    {
+        return FloatExp(m_mantissa * other.m_mantissa, m_exponent + other.m_exponent);
+    }
+
+    FloatExp FloatExp::operator/(const FloatExp &other) const
+    {
+        return FloatExp(m_mantissa / other.m_mantissa, m_exponent - other.m_exponent);
+    }
+
+    bool FloatExp::operator==(const FloatExp &other) const noexcept
+    {
+        return compare(other) == 0;
+    }
+
+    bool FloatExp::operator!=(const FloatExp &other) const noexcept
+    {
+        return compare(other) != 0;
+    }
+
+    bool FloatExp::operator<(const FloatExp &other) const noexcept
+    {
+        return compare(other) < 0;
+    }
+
+    bool FloatExp::operator>(const FloatExp &other) const noexcept
+    {
+        return compare(other) > 0;
+    }
+
+    bool FloatExp::operator<=(const FloatExp &other) const noexcept
+    {
+        return compare(other) <= 0;
+    }
+
+    bool FloatExp::operator>=(const FloatExp &other) const noexcept
+    {
+        return compare(other) >= 0;
+    }
+
+    void FloatExp::normalize()
+    {
+        if (m_mantissa == 0.0 || !std::isfinite(m_mantissa))
+        {
+            m_exponent = 0;
+            return;
+        }
+
+        int shift = 0;
+        m_mantissa = std::frexp(m_mantissa, &shift);
+        m_exponent += shift;
+    }
+
+    int FloatExp::compare(const FloatExp &other) const noexcept
+    {
+        // Values of opposite signs, or zero, are told apart by their mantissas alone
+        if (m_mantissa == 0.0 || other.m_mantissa == 0.0 || (m_mantissa < 0.0) != (other.m_mantissa < 0.0))
+            return (m_mantissa > other.m_mantissa) - (m_mantissa < other.m_mantissa);
+
+        // Otherwise the larger exponent has the larger magnitude
+        if (m_exponent != other.m_exponent)
+            return (m_exponent > other.m_exponent) == (m_mantissa > 0.0) ? 1 : -1;
+
+        return (m_mantissa > other.m_mantissa) - (m_mantissa < other.m_mantissa);
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef _MANDELBROT_LIB_KERNEL_FLOAT_EXP_H_
+#define _MANDELBROT_LIB_KERNEL_FLOAT_EXP_H_
+
+#include <string>
+
+#include <mpfr.h>
+
+namespace mandelbrot
+{
+
+/**
+ * @class FloatExp
+ * @brief Double mantissa with a separate binary exponent, for quantities such as the scale of deep
+ *        zoom frames that fall far outside the range of a double. Holds mantissa * 2^exponent, with
+ *        the magnitude of the mantissa in [0.5, 1) unless the value is zero.
+ */
+class FloatExp
+{
+public:
+    /// Constructs zero
+    FloatExp();
+
+    /// Constructs the value of a double
+    FloatExp(double value);
+
+    /// Constructs mantissa * 2^exponent
+    FloatExp(double mantissa, long exponent);
+
+    /**
+     * @brief Parses a decimal number such as "1.5e-500", whose exponent may be beyond the range of a double
+     * @throws std::invalid_argument if the string is not a number
+     */
+    static FloatExp fromString(const std::string &str);
+
+    /// Returns 2^x, for any x
+    static FloatExp exp2(double x);
+
+    /// Returns the value as a decimal number in scientific notation, with up to the given number of significant
+    /// digits. The default tells every double mantissa apart
+    std::string toString(int digits = 17) const;
+
+    /// Returns the value as a double, which is zero or infinite if it is outside the range of a double
+    double toDouble() const;
+
+    /// Returns the base 2 logarithm of the magnitude of the value
+    double log2() const;
+
+    double getMantissa() const noexcept;
+    long getExponent() const noexcept;
+
+    /// Sets an MPFR number to the value, which it holds exactly if it has 53 bits of precision or more
+    void toMpfr(mpfr_ptr out) const;
+
+    FloatExp operator*(const FloatExp &other) const;
+    FloatExp operator/(const FloatExp &other) const;
+
+    bool operator==(const FloatExp &other) const noexcept;
+    bool operator!=(const FloatExp &other) const noexcept;
+    bool operator<(const FloatExp &other) const noexcept;
+    bool operator>(const FloatExp &other) const noexcept;
+    bool operator<=(const FloatExp &other) const noexcept;
+    bool operator>=(const FloatExp &other) const noexcept;
+
+private:
+    /// Brings the mantissa back into [0.5, 1), moving its exponent into \ref m_exponent
+    void normalize();
+
+    /// Returns a negative number, zero or a positive number if the value is less than, equal to or greater than other
+    int compare(const FloatExp &other) const noexcept;
+
+private:
+    double m_mantissa;
+
+    long m_exponent;
+};
+
+}
+
+#endif // _MANDELBROT_LIB_KERNEL_FLOAT_EXP_H_
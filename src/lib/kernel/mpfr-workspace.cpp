@@ -0,0 +1,53 @@
+#include "kernel/mpfr-workspace.h"
+
+namespace mandelbrot
+{
+    MpfrWorkspace::MpfrWorkspace(int precision) :
+        m_registers(),
+        m_taken(0),
+        m_precision(precision)
+    {
+        for (mpfr_t &reg : m_registers)
+            mpfr_init2(reg, precision);
+    }
+
+    MpfrWorkspace::~MpfrWorkspace()
+    {
+        for (mpfr_t &reg : m_registers)
+            mpfr_clear(reg);
+    }
+
+    void MpfrWorkspace::setPrecision(int precision)
+    {
+        if (precision == m_precision)
+            return;
+
+        for (mpfr_t &reg : m_registers)
+            mpfr_set_prec(reg, precision);
+        m_precision = precision;
+    }
+
+    int MpfrWorkspace::getPrecision() const noexcept
+    {
+        return m_precision;
+    }
+
+    MpfrWorkspace::Scope::Scope(MpfrWorkspace &workspace) noexcept :
+        m_workspace(workspace),
+        m_first(workspace.m_taken)
+    {
+    }
+
+    MpfrWorkspace::Scope::~Scope()
+    {
+        m_workspace.m_taken = m_first;
+    }
+
+    mpfr_ptr MpfrWorkspace::Scope::take() noexcept
+    {
+        if (m_workspace.m_taken == NumRegisters)
+            return nullptr;
+
+        return m_workspace.m_registers[m_workspace.m_taken++];
+    }
+}
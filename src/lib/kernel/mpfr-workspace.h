@@ -0,0 +1,72 @@
+#ifndef _MANDELBROT_LIB_KERNEL_MPFR_WORKSPACE_H_
+#define _MANDELBROT_LIB_KERNEL_MPFR_WORKSPACE_H_
+
+#include <mpfr.h>
+
+#include "kernel/precision.h"
+
+namespace mandelbrot
+{
+
+/**
+ * @class MpfrWorkspace
+ * @brief Fixed set of preallocated MPFR scratch registers sharing a single precision, owned by one thread at a time.
+ *        Registers are taken in stack order through a \ref MpfrWorkspace::Scope, and given back when it ends, so
+ *        that the calculations using them allocate no memory of their own.
+ */
+class MpfrWorkspace
+{
+public:
+    /// Number of registers, enough for the most demanding calculation plus the one it is nested in
+    static constexpr int NumRegisters = 16;
+
+    /// Constructs the registers with the given number of bits of precision
+    explicit MpfrWorkspace(int precision = MinMpfrPrecision);
+    ~MpfrWorkspace();
+
+    MpfrWorkspace(const MpfrWorkspace &) = delete;
+    MpfrWorkspace &operator=(const MpfrWorkspace &) = delete;
+
+    /// Changes the precision of every register, which reallocates them only if it differs from the current one.
+    /// Must not be called while registers are taken
+    void setPrecision(int precision);
+
+    /// Returns the number of bits of precision of the registers
+    int getPrecision() const noexcept;
+
+    /**
+     * @class MpfrWorkspace::Scope
+     * @brief Registers taken from a workspace for the lifetime of the scope. Scopes of the same workspace
+     *        must end in the opposite order to which they began.
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(MpfrWorkspace &workspace) noexcept;
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        /// Takes the next free register, whose value is undefined. Returns nullptr if all of them are taken
+        mpfr_ptr take() noexcept;
+
+    private:
+        MpfrWorkspace &m_workspace;
+
+        /// Number of registers that were taken when the scope began
+        int m_first;
+    };
+
+private:
+    mpfr_t m_registers[NumRegisters];
+
+    /// Number of registers currently taken
+    int m_taken;
+
+    int m_precision;
+};
+
+}
+
+#endif // _MANDELBROT_LIB_KERNEL_MPFR_WORKSPACE_H_
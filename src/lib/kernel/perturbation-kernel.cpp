@@ -0,0 +1,218 @@
+#include <cmath>
+
+#include "kernel/perturbation-kernel.h"
+
+namespace mandelbrot
+{
+    /// A point is considered glitched when |z| < GlitchTolerance * |Z| (Pauldelbrot's criterion), squared here
+    static constexpr double GlitchTolerance2 = 1e-6;
+
+    /// Rescaled mantissas are brought back down by 2^RescaleBits once their squared magnitude passes RescaleLimit
+    static constexpr int RescaleBits = 64;
+    static constexpr double RescaleLimit = 0x1p128;
+
+    int perturbationScalar(const ReferenceOrbit &orbit, const SeriesApproximation *series, const double *dcRe,
+                           const double *dcIm, int count, int maxIterations, EscapeTimeRow &out, bool *glitched)
+    {
+        constexpr double Limit = 4.0;
+
+        const double *refRe = orbit.getReal();
+        const double *refIm = orbit.getImag();
+        const int refIterations = orbit.getIterationCount();
+        const int skippedIterations = series ? series->getSkippedIterations() : 0;
+
+        int numGlitched = 0;
+
+        for (int i = 0; i < count; ++i)
+        {
+            const double dcR = dcRe[i];
+            const double dcI = dcIm[i];
+
+            double deltaRe = 0.0,
+                   deltaIm = 0.0,
+                   zRe = 0.0,
+                   zIm = 0.0,
+                   dzRe = 0.0,
+                   dzIm = 0.0,
+                   temp = 0.0;
+            bool isGlitched = false;
+            int numIterations = 0;
+
+            if (skippedIterations > 0)
+            {
+                std::complex<double> delta, dz;
+                series->evaluate(std::complex<double>(dcR, dcI), delta, dz);
+
+                numIterations = skippedIterations;
+                deltaRe = delta.real();
+                deltaIm = delta.imag();
+                zRe = refRe[numIterations] + deltaRe;
+                zIm = refIm[numIterations] + deltaIm;
+                dzRe = dz.real();
+                dzIm = dz.imag();
+            }
+
+            do
+            {
+                // Z(n + 1) must be available to take another step
+                if (numIterations >= refIterations)
+                {
+                    isGlitched = true;
+                    break;
+                }
+
+                const double refR = refRe[numIterations];
+                const double refI = refIm[numIterations];
+
+                // Derivative of z, where z = Z + delta
+                temp = 2.0 * (zRe * dzRe - dzIm * zIm) + 1.0;
+                dzIm = 2.0 * (zIm * dzRe + zRe * dzIm);
+                dzRe = temp;
+
+                // delta(n + 1) = (2 * Z(n) + delta(n)) * delta(n) + dc
+                const double twoZRe = 2.0 * refR + deltaRe;
+                const double twoZIm = 2.0 * refI + deltaIm;
+                temp = twoZRe * deltaRe - twoZIm * deltaIm + dcR;
+                deltaIm = twoZRe * deltaIm + twoZIm * deltaRe + dcI;
+                deltaRe = temp;
+
+                ++numIterations;
+
+                const double nextRefR = refRe[numIterations];
+                const double nextRefI = refIm[numIterations];
+                zRe = nextRefR + deltaRe;
+                zIm = nextRefI + deltaIm;
+
+                const double zNorm = zRe * zRe + zIm * zIm;
+                if (zNorm > Limit)
+                    break;
+
+                if (zNorm < GlitchTolerance2 * (nextRefR * nextRefR + nextRefI * nextRefI))
+                {
+                    isGlitched = true;
+                    break;
+                }
+            } while (numIterations < maxIterations);
+
+            out.zRe[i] = zRe;
+            out.zIm[i] = zIm;
+            out.dzRe[i] = dzRe;
+            out.dzIm[i] = dzIm;
+            out.iterations[i] = numIterations;
+
+            glitched[i] = isGlitched;
+            if (isGlitched)
+                ++numGlitched;
+        }
+
+        return numGlitched;
+    }
+
+    int perturbationRescaled(const ReferenceOrbit &orbit, const FloatExp &scale, const double *uRe, const double *uIm,
+                             int count, int maxIterations, EscapeTimeRow &out, bool *glitched)
+    {
+        constexpr double Limit = 4.0;
+
+        const double *refRe = orbit.getReal();
+        const double *refIm = orbit.getImag();
+        const int refIterations = orbit.getIterationCount();
+        const double scaleMantissa = scale.getMantissa();
+        const int scaleExponent = static_cast<int>(scale.getExponent());
+
+        int numGlitched = 0;
+
+        for (int i = 0; i < count; ++i)
+        {
+            const double uR = uRe[i];
+            const double uI = uIm[i];
+
+            // delta = w * 2^deltaExponent, and the derivative with respect to u, dz * scale = v * 2^derivativeExponent.
+            // deltaUnit is 2^deltaExponent, which is zero while delta is too small to make any difference to z, and
+            // the offset of the point and the scale added to the derivative are given in units of the exponents
+            int deltaExponent = scaleExponent,
+                derivativeExponent = scaleExponent;
+            double deltaUnit = std::ldexp(1.0, deltaExponent),
+                   offsetFactor = scaleMantissa,
+                   derivativeStep = scaleMantissa;
+            double wRe = 0.0,
+                   wIm = 0.0,
+                   zRe = 0.0,
+                   zIm = 0.0,
+                   vRe = 0.0,
+                   vIm = 0.0,
+                   temp = 0.0;
+            bool isGlitched = false;
+            int numIterations = 0;
+
+            do
+            {
+                // Z(n + 1) must be available to take another step
+                if (numIterations >= refIterations)
+                {
+                    isGlitched = true;
+                    break;
+                }
+
+                const double refR = refRe[numIterations];
+                const double refI = refIm[numIterations];
+
+                // Derivative of z with respect to u, which is the derivative with respect to c times the scale
+                temp = 2.0 * (zRe * vRe - vIm * zIm) + derivativeStep;
+                vIm = 2.0 * (zIm * vRe + zRe * vIm);
+                vRe = temp;
+
+                // delta(n + 1) = (2 * Z(n) + delta(n)) * delta(n) + dc, divided through by 2^deltaExponent
+                const double twoZRe = 2.0 * refR + wRe * deltaUnit;
+                const double twoZIm = 2.0 * refI + wIm * deltaUnit;
+                temp = twoZRe * wRe - twoZIm * wIm + uR * offsetFactor;
+                wIm = twoZRe * wIm + twoZIm * wRe + uI * offsetFactor;
+                wRe = temp;
+
+                if (wRe * wRe + wIm * wIm > RescaleLimit)
+                {
+                    wRe = std::ldexp(wRe, -RescaleBits);
+                    wIm = std::ldexp(wIm, -RescaleBits);
+                    deltaExponent += RescaleBits;
+                    deltaUnit = std::ldexp(1.0, deltaExponent);
+                    offsetFactor = std::ldexp(scaleMantissa, scaleExponent - deltaExponent);
+                }
+                if (vRe * vRe + vIm * vIm > RescaleLimit)
+                {
+                    vRe = std::ldexp(vRe, -RescaleBits);
+                    vIm = std::ldexp(vIm, -RescaleBits);
+                    derivativeExponent += RescaleBits;
+                    derivativeStep = std::ldexp(scaleMantissa, scaleExponent - derivativeExponent);
+                }
+
+                ++numIterations;
+
+                const double nextRefR = refRe[numIterations];
+                const double nextRefI = refIm[numIterations];
+                zRe = nextRefR + wRe * deltaUnit;
+                zIm = nextRefI + wIm * deltaUnit;
+
+                const double zNorm = zRe * zRe + zIm * zIm;
+                if (zNorm > Limit)
+                    break;
+
+                if (zNorm < GlitchTolerance2 * (nextRefR * nextRefR + nextRefI * nextRefI))
+                {
+                    isGlitched = true;
+                    break;
+                }
+            } while (numIterations < maxIterations);
+
+            out.zRe[i] = zRe;
+            out.zIm[i] = zIm;
+            out.dzRe[i] = std::ldexp(vRe, derivativeExponent);
+            out.dzIm[i] = std::ldexp(vIm, derivativeExponent);
+            out.iterations[i] = numIterations;
+
+            glitched[i] = isGlitched;
+            if (isGlitched)
+                ++numGlitched;
+        }
+
+        return numGlitched;
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef _MANDELBROT_LIB_KERNEL_PERTURBATION_KERNEL_H_
+#define _MANDELBROT_LIB_KERNEL_PERTURBATION_KERNEL_H_
+
+#include "kernel/escape-time-kernel.h"
+#include "kernel/float-exp.h"
+#include "kernel/reference-orbit.h"
+#include "kernel/series-approximation.h"
+
+namespace mandelbrot
+{
+
+/**
+ * @brief Iterates a batch of points as perturbations of a high precision reference orbit. Each point c is given as its offset dc from the
+ *        reference point, and only the offset of z from the reference orbit is iterated, so
+ *        double precision is sufficient far beyond the zoom depth at which c itself can no
+ *        longer be represented as a double.
+ *
+ *        Points whose perturbation loses too much precision (when z passes close to zero
+ *        relative to the reference orbit), or that outlive the reference orbit, are flagged as
+ *        glitched and should be iterated again against a different reference.
+ *
+ * @param orbit Reference orbit the points are relative to
+ * @param series Approximation of the orbit, used to skip the first iterations. May be nullptr
+ * @param dcRe Real components of each point's offset from the reference point
+ * @param dcIm Imaginary components of each point's offset from the reference point
+ * @param count Number of points to iterate
+ * @param maxIterations Maximum number of iterations before assuming a point is within the set
+ * @param out Destination of the final z, dz and iteration count of each point
+ * @param glitched Set to true for each point that must be iterated again, false otherwise
+ * @return Number of glitched points
+ */
+int perturbationScalar(const ReferenceOrbit &orbit, const SeriesApproximation *series, const double *dcRe,
+                       const double *dcIm, int count, int maxIterations, EscapeTimeRow &out, bool *glitched);
+
+/**
+ * @brief Iterates a batch of points as \ref perturbationScalar() does, for frames so deep that the offsets of
+ *        their points from the reference point are beyond the range of a double. The offsets are given in units
+ *        of the scale instead, and the offset of z from the reference orbit is kept as a double mantissa and a
+ *        separate binary exponent, rescaled whenever the mantissa grows too large, until it comes within range.
+ *        The series approximation is not used.
+ *
+ * @param orbit Reference orbit the points are relative to
+ * @param scale Unit of the offsets, such as the distance between neighbouring pixels
+ * @param uRe Real components of each point's offset from the reference point, in units of the scale
+ * @param uIm Imaginary components of each point's offset from the reference point, in units of the scale
+ * @param count Number of points to iterate
+ * @param maxIterations Maximum number of iterations before assuming a point is within the set
+ * @param out Destination of the final z, dz and iteration count of each point. The derivative is taken
+ *            with respect to the offset in units of the scale, so it is the derivative of z multiplied by the scale
+ * @param glitched Set to true for each point that must be iterated again, false otherwise
+ * @return Number of glitched points
+ */
+int perturbationRescaled(const ReferenceOrbit &orbit, const FloatExp &scale, const double *uRe, const double *uIm,
+                         int count, int maxIterations, EscapeTimeRow &out, bool *glitched);
+
+}
+
+#endif // _MANDELBROT_LIB_KERNEL_PERTURBATION_KERNEL_H_
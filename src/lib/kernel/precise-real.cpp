@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+#include "kernel/precise-real.h"
+#include "kernel/precision.h"
+
+namespace mandelbrot
+{
+    /// Bits of precision of a double
+    static constexpr int DoublePrecision = 53;
+
+    PreciseReal::PreciseReal() :
+        m_value()
+    {
+        mpfr_init2(m_value, DoublePrecision);
+        mpfr_set_zero(m_value, 0);
+    }
+
+    PreciseReal::PreciseReal(double value) :
+        m_value()
+    {
+        mpfr_init2(m_value, DoublePrecision);
+        mpfr_set_d(m_value, value, MPFR_RNDN);
+    }
+
+    PreciseReal::PreciseReal(const PreciseReal &other) :
+        m_value()
+    {
+        mpfr_init2(m_value, mpfr_get_prec(other.m_value));
+        mpfr_set(m_value, other.m_value, MPFR_RNDN);
+    }
+
+    PreciseReal &PreciseReal::operator=(const PreciseReal &other)
+    {
+        if (this != &other)
+        {
+            mpfr_set_prec(m_value, mpfr_get_prec(other.m_value));
+            mpfr_set(m_value, other.m_value, MPFR_RNDN);
+        }
+        return *this;
+    }
+
+    PreciseReal::~PreciseReal()
+    {
+        mpfr_clear(m_value);
+    }
+
+    PreciseReal PreciseReal::fromString(const std::string &str)
+    {
+        // Each decimal digit carries log2(10) bits. Digits after a long run of zeros following the decimal
+        // point are covered as well, as the leading zeros are counted among them.
+        const size_t numDigits = std::count_if(str.begin(), std::find_if(str.begin(), str.end(), [](char c) {
+            return c == 'e' || c == 'E';
+        }), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; });
+        const int bits = std::max(MinMpfrPrecision, static_cast<int>(std::ceil(numDigits * std::log2(10.0))) + PrecisionGuardBits);
+
+        PreciseReal result;
+        mpfr_set_prec(result.m_value, bits);
+        if (mpfr_set_str(result.m_value, str.c_str(), 10, MPFR_RNDN) != 0 || !mpfr_number_p(result.m_value))
+            throw std::invalid_argument("Not a number: " + str);
+
+        return result;
+    }
+
+    std::string PreciseReal::toString() const
+    {
+        if (mpfr_zero_p(m_value))
+            return "0";
+
+        mpfr_exp_t exponent = 0;
+        char *digits = mpfr_get_str(nullptr, &exponent, 10, 0, m_value, MPFR_RNDN);
+        std::string result { digits };
+        mpfr_free_str(digits);
+
+        const size_t first = result[0] == '-' ? 1 : 0;
+        result.erase(std::max(result.find_last_not_of('0') + 1, first + 1));
+
+        // The digits are those of 0.ddd * 10^exponent. Coordinates of the plane are written out in full,
+        // anything else in scientific notation.
+        if (exponent > -8 && exponent <= 1)
+        {
+            if (exponent <= 0)
+                result.insert(first, "0." + std::string(static_cast<size_t>(-exponent), '0'));
+            else if (result.size() > first + 1)
+                result.insert(first + 1, ".");
+            return result;
+        }
+
+        if (result.size() > first + 1)
+            result.insert(first + 1, ".");
+        return result + "e" + std::to_string(exponent - 1);
+    }
+
+    double PreciseReal::toDouble() const
+    {
+        return mpfr_get_d(m_value, MPFR_RNDN);
+    }
+
+    double PreciseReal::getRemainder() const
+    {
+        mpfr_t remainder;
+        mpfr_init2(remainder, mpfr_get_prec(m_value));
+        mpfr_sub_d(remainder, m_value, mpfr_get_d(m_value, MPFR_RNDN), MPFR_RNDN);
+        const double result = mpfr_get_d(remainder, MPFR_RNDN);
+        mpfr_clear(remainder);
+        return result;
+    }
+
+    int PreciseReal::getPrecision() const noexcept
+    {
+        return static_cast<int>(mpfr_get_prec(m_value));
+    }
+
+    void PreciseReal::add(const FloatExp &scale, double offset)
+    {
+        // Bits from the leading bit of the value, or of the unit if the value is smaller, down to the scale
+        const long leading = mpfr_zero_p(m_value) ? 1 : std::max<long>(mpfr_get_exp(m_value), 1);
+        const long bits = std::max<long>(leading - scale.getExponent() + PrecisionGuardBits, MinMpfrPrecision);
+        if (bits > mpfr_get_prec(m_value))
+            mpfr_prec_round(m_value, bits, MPFR_RNDN);
+
+        // The product of two doubles is exact in twice their precision
+        mpfr_t delta;
+        mpfr_init2(delta, 2 * DoublePrecision);
+        scale.toMpfr(delta);
+        mpfr_mul_d(delta, delta, offset, MPFR_RNDN);
+        mpfr_add(m_value, m_value, delta, MPFR_RNDN);
+        mpfr_clear(delta);
+    }
+
+    mpfr_srcptr PreciseReal::get() const noexcept
+    {
+        return m_value;
+    }
+
+    bool PreciseReal::operator==(const PreciseReal &other) const noexcept
+    {
+        return mpfr_equal_p(m_value, other.m_value) != 0;
+    }
+
+    bool PreciseReal::operator!=(const PreciseReal &other) const noexcept
+    {
+        return !(*this == other);
+    }
+}
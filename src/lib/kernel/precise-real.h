@@ -0,0 +1,67 @@
+#ifndef _MANDELBROT_LIB_KERNEL_PRECISE_REAL_H_
+#define _MANDELBROT_LIB_KERNEL_PRECISE_REAL_H_
+
+#include <string>
+
+#include <mpfr.h>
+
+#include "kernel/float-exp.h"
+
+namespace mandelbrot
+{
+
+/**
+ * @class PreciseReal
+ * @brief Real number held by MPFR, such as a coordinate of the center of a deep zoom frame. Its precision
+ *        is that of the value it was given, and grows as needed when it is moved by small offsets.
+ */
+class PreciseReal
+{
+public:
+    /// Constructs zero
+    PreciseReal();
+
+    /// Constructs the exact value of a double
+    PreciseReal(double value);
+
+    PreciseReal(const PreciseReal &other);
+    PreciseReal &operator=(const PreciseReal &other);
+    ~PreciseReal();
+
+    /**
+     * @brief Parses a decimal number such as "-1.74975914513036646"; every digit given is kept
+     * @throws std::invalid_argument if the string is not a number
+     */
+    static PreciseReal fromString(const std::string &str);
+
+    /// Returns the value as a decimal number, with as many digits as its precision calls for
+    std::string toString() const;
+
+    /// Returns the value rounded to the nearest double
+    double toDouble() const;
+
+    /// Returns the value less \ref toDouble(), rounded to the nearest double. The two form a double-double
+    double getRemainder() const;
+
+    /// Returns the number of bits of precision of the value
+    int getPrecision() const noexcept;
+
+    /**
+     * @brief Moves the value by offset * scale, such as a number of pixels of a frame of the given scale.
+     *        The precision of the value is extended as needed to tell apart positions at the scale.
+     */
+    void add(const FloatExp &scale, double offset);
+
+    /// Returns the MPFR number holding the value
+    mpfr_srcptr get() const noexcept;
+
+    bool operator==(const PreciseReal &other) const noexcept;
+    bool operator!=(const PreciseReal &other) const noexcept;
+
+private:
+    mpfr_t m_value;
+};
+
+}
+
+#endif // _MANDELBROT_LIB_KERNEL_PRECISE_REAL_H_
@@ -0,0 +1,47 @@
+#include <algorithm>
+#include <cmath>
+
+#include "kernel/precision.h"
+
+namespace mandelbrot
+{
+    /// Bits of mantissa of each fixed-size arithmetic, including the implicit leading bit
+    static constexpr int FloatBits = 24;
+    static constexpr int DoubleBits = 53;
+    static constexpr int DoubleDoubleBits = 106;
+
+    int getRequiredPrecision(const FloatExp &scale)
+    {
+        // The coordinates of the points of interest are no larger than 2 in magnitude, so neighbouring pixels
+        // differ from the first bit on in log2(2 / scale) bits
+        if (scale <= FloatExp())
+            return DoubleBits;
+
+        return static_cast<int>(std::ceil(1.0 - scale.log2())) + PrecisionGuardBits;
+    }
+
+    int getPrecisionBits(Precision precision, const FloatExp &scale)
+    {
+        switch (precision)
+        {
+        case Precision::Float: return FloatBits;
+        case Precision::Double: return DoubleBits;
+        case Precision::DoubleDouble: return DoubleDoubleBits;
+        case Precision::Multi: break;
+        }
+
+        return std::max(MinMpfrPrecision, getRequiredPrecision(scale));
+    }
+
+    Precision selectPrecision(const FloatExp &scale, Precision minimum)
+    {
+        const int required = getRequiredPrecision(scale);
+        for (Precision precision : { Precision::Float, Precision::Double, Precision::DoubleDouble })
+        {
+            if (precision >= minimum && getPrecisionBits(precision, scale) >= required)
+                return precision;
+        }
+
+        return Precision::Multi;
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef _MANDELBROT_LIB_KERNEL_PRECISION_H_
+#define _MANDELBROT_LIB_KERNEL_PRECISION_H_
+
+#include "kernel/float-exp.h"
+
+namespace mandelbrot
+{
+
+/// Arithmetic used to iterate the pixels of a frame, from the fastest to the most precise
+enum class Precision
+{
+    /// Single precision. The vectorized kernels iterate twice as many points at a time as with doubles
+    Float,
+
+    /// Double precision
+    Double,
+
+    /// Pairs of doubles, see \ref DoubleDouble. Only frames rendered with \ref DeepZoomMode::Precise are iterated
+    /// in double-double: with \ref DeepZoomMode::Perturbation, frames needing more than double precision iterate
+    /// their pixels in double precision, relative to a reference orbit
+    DoubleDouble,
+
+    /// MPFR, with as many bits as the scale of the frame calls for
+    Multi
+};
+
+/// Bits of precision a frame is iterated with, beyond those needed to tell apart the coordinates of neighbouring pixels
+constexpr int PrecisionGuardBits = 12;
+
+/// Fewest bits MPFR numbers are given, which is the size of a single limb
+constexpr int MinMpfrPrecision = 64;
+
+/// Returns the number of bits of precision needed to iterate a frame of the given scale, including the guard bits
+int getRequiredPrecision(const FloatExp &scale);
+
+/// Returns the number of bits of mantissa of the given arithmetic. For \ref Precision::Multi, this is the
+/// number of bits MPFR numbers are given for a frame of the given scale
+int getPrecisionBits(Precision precision, const FloatExp &scale);
+
+/// Returns the fastest arithmetic, no less precise than the given minimum, that is precise enough to iterate
+/// the coordinates of the pixels of a frame of the given scale directly. Perturbation frames override this
+/// beyond \ref Precision::Double, see \ref Precision::DoubleDouble
+Precision selectPrecision(const FloatExp &scale, Precision minimum);
+
+}
+
+#endif // _MANDELBROT_LIB_KERNEL_PRECISION_H_
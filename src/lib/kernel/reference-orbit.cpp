@@ -0,0 +1,76 @@
+#include "kernel/reference-orbit.h"
+
+namespace mandelbrot
+{
+    ReferenceOrbit::ReferenceOrbit() :
+        m_real(),
+        m_imag(),
+        m_escaped(false)
+    {
+    }
+
+    void ReferenceOrbit::compute(mpfr_srcptr cRe, mpfr_srcptr cIm, int maxIterations, MpfrWorkspace &workspace)
+    {
+        m_real.clear();
+        m_imag.clear();
+        m_real.reserve(maxIterations + 1);
+        m_imag.reserve(maxIterations + 1);
+        m_escaped = false;
+
+        MpfrWorkspace::Scope registers(workspace);
+        mpfr_ptr zR = registers.take(), zI = registers.take(), zR2 = registers.take(), zI2 = registers.take(),
+                 temp = registers.take();
+        mpfr_set_zero(zR, 0);
+        mpfr_set_zero(zI, 0);
+        mpfr_set_zero(zR2, 0);
+        mpfr_set_zero(zI2, 0);
+
+        m_real.push_back(0.0);
+        m_imag.push_back(0.0);
+
+        for (int n = 0; n < maxIterations; ++n)
+        {
+            //zI = 2 * zR * zI + cI
+            mpfr_mul(zI, zI, zR, MPFR_RNDN);
+            mpfr_mul_2ui(zI, zI, 1, MPFR_RNDN);
+            mpfr_add(zI, zI, cIm, MPFR_RNDN);
+
+            //zR = zR2 - zI2 + cR
+            mpfr_sub(zR, zR2, zI2, MPFR_RNDN);
+            mpfr_add(zR, zR, cRe, MPFR_RNDN);
+
+            mpfr_sqr(zR2, zR, MPFR_RNDN);
+            mpfr_sqr(zI2, zI, MPFR_RNDN);
+
+            m_real.push_back(mpfr_get_d(zR, MPFR_RNDN));
+            m_imag.push_back(mpfr_get_d(zI, MPFR_RNDN));
+
+            mpfr_add(temp, zR2, zI2, MPFR_RNDN);
+            if (mpfr_cmp_ui(temp, 4) > 0)
+            {
+                m_escaped = true;
+                break;
+            }
+        }
+    }
+
+    int ReferenceOrbit::getIterationCount() const noexcept
+    {
+        return static_cast<int>(m_real.size()) - 1;
+    }
+
+    bool ReferenceOrbit::hasEscaped() const noexcept
+    {
+        return m_escaped;
+    }
+
+    const double *ReferenceOrbit::getReal() const noexcept
+    {
+        return m_real.data();
+    }
+
+    const double *ReferenceOrbit::getImag() const noexcept
+    {
+        return m_imag.data();
+    }
+}
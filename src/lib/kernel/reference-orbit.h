@@ -0,0 +1,60 @@
+#ifndef _MANDELBROT_LIB_KERNEL_REFERENCE_ORBIT_H_
+#define _MANDELBROT_LIB_KERNEL_REFERENCE_ORBIT_H_
+
+#include <vector>
+
+#include <mpfr.h>
+
+#include "kernel/mpfr-workspace.h"
+
+namespace mandelbrot
+{
+
+/**
+ * @class ReferenceOrbit
+ * @brief Orbit Z(n) of a single point under z -> z^2 + c, calculated with arbitrary precision
+ *        and stored as doubles. Used by the perturbation kernel to iterate nearby points as
+ *        low precision offsets from the orbit.
+ */
+class ReferenceOrbit
+{
+public:
+    /// Constructs an empty orbit
+    ReferenceOrbit();
+
+    /**
+     * @brief Calculates the orbit of the point c = cRe + cIm * i, stopping once the orbit escapes
+     *        or the maximum number of iterations has been reached.
+     * @param cRe Real component of the reference point
+     * @param cIm Imaginary component of the reference point
+     * @param maxIterations Maximum number of iterations
+     * @param workspace Registers the calculations are done in, whose precision is used
+     */
+    void compute(mpfr_srcptr cRe, mpfr_srcptr cIm, int maxIterations, MpfrWorkspace &workspace);
+
+    /// Returns the number of iterations in the orbit. Z(0) through Z(n) are available, where n is the returned value
+    int getIterationCount() const noexcept;
+
+    /// Returns true if the orbit breached the escape radius before reaching the maximum number of iterations
+    bool hasEscaped() const noexcept;
+
+    /// Returns the real components of Z(0) .. Z(n)
+    const double *getReal() const noexcept;
+
+    /// Returns the imaginary components of Z(0) .. Z(n)
+    const double *getImag() const noexcept;
+
+private:
+    /// Real components of the orbit
+    std::vector<double> m_real;
+
+    /// Imaginary components of the orbit
+    std::vector<double> m_imag;
+
+    /// Set if the orbit escaped before reaching the maximum iteration count
+    bool m_escaped;
+};
+
+}
+
+#endif // _MANDELBROT_LIB_KERNEL_REFERENCE_ORBIT_H_
@@ -0,0 +1,143 @@
+#include <cmath>
+
+#include "kernel/series-approximation.h"
+
+namespace mandelbrot
+{
+    /// The series is truncated once the cubic term exceeds this fraction of the linear term
+    static constexpr double TruncationTolerance = 1e-8;
+
+    /// Largest relative difference allowed between the series and a directly iterated probe point
+    static constexpr double ProbeTolerance = 1e-6;
+
+    SeriesApproximation::SeriesApproximation() :
+        m_a(),
+        m_b(),
+        m_c(),
+        m_radius(0.0),
+        m_skippedIterations(0)
+    {
+    }
+
+    void SeriesApproximation::compute(const ReferenceOrbit &orbit, double halfWidth, double halfHeight)
+    {
+        reset();
+
+        m_radius = std::hypot(halfWidth, halfHeight);
+        if (m_radius <= 0.0)
+            return;
+
+        const double *refRe = orbit.getReal();
+        const double *refIm = orbit.getImag();
+
+        // At least one iteration is always left to the perturbation kernel
+        const int lastIteration = orbit.getIterationCount() - 1;
+
+        // Coefficients of iteration 0 are all zero, as delta(0) = 0
+        std::complex<double> a, b, c;
+        m_a.push_back(a);
+        m_b.push_back(b);
+        m_c.push_back(c);
+
+        // A(n+1) = 2 Z(n) A(n) + 1, B(n+1) = 2 Z(n) B(n) + A(n)^2, C(n+1) = 2 Z(n) C(n) + 2 A(n) B(n)
+        for (int n = 0; n < lastIteration; ++n)
+        {
+            const std::complex<double> twoZ(2.0 * refRe[n], 2.0 * refIm[n]);
+            const std::complex<double> nextA = twoZ * a + m_radius;
+            const std::complex<double> nextB = twoZ * b + a * a;
+            const std::complex<double> nextC = twoZ * c + 2.0 * a * b;
+
+            if (std::abs(nextC) > TruncationTolerance * std::abs(nextA))
+                break;
+
+            a = nextA;
+            b = nextB;
+            c = nextC;
+            m_a.push_back(a);
+            m_b.push_back(b);
+            m_c.push_back(c);
+        }
+
+        int candidate = static_cast<int>(m_a.size()) - 1;
+
+        // Probe points on the corners and edges of the region are iterated directly. The
+        // series must agree with each of them at the iteration count that will be skipped.
+        const std::complex<double> probes[] = {
+            { -halfWidth, -halfHeight }, { halfWidth, -halfHeight },
+            { -halfWidth, halfHeight }, { halfWidth, halfHeight },
+            { -halfWidth, 0.0 }, { halfWidth, 0.0 },
+            { 0.0, -halfHeight }, { 0.0, halfHeight }
+        };
+
+        constexpr int NumProbes = sizeof(probes) / sizeof(probes[0]);
+        const int stride = candidate + 1;
+        std::vector<std::complex<double>> probeDelta(NumProbes * stride);
+        for (int p = 0; p < NumProbes; ++p)
+        {
+            std::complex<double> delta;
+            for (int n = 0; n < candidate; ++n)
+            {
+                delta = (2.0 * std::complex<double>(refRe[n], refIm[n]) + delta) * delta + probes[p];
+                probeDelta[p * stride + n + 1] = delta;
+
+                // A probe that escapes early limits the skip to before its escape
+                if (std::norm(std::complex<double>(refRe[n + 1], refIm[n + 1]) + delta) > 4.0)
+                {
+                    candidate = n;
+                    break;
+                }
+            }
+        }
+
+        auto agreesWithProbes = [&](int n) {
+            for (int p = 0; p < NumProbes; ++p)
+            {
+                const std::complex<double> expected = probeDelta[p * stride + n];
+                if (std::abs(evaluateDelta(n, probes[p] / m_radius) - expected) > ProbeTolerance * std::abs(expected))
+                    return false;
+            }
+            return true;
+        };
+
+        while (candidate > 0 && !agreesWithProbes(candidate))
+            --candidate;
+
+        m_skippedIterations = candidate;
+    }
+
+    void SeriesApproximation::reset()
+    {
+        m_a.clear();
+        m_b.clear();
+        m_c.clear();
+        m_radius = 0.0;
+        m_skippedIterations = 0;
+    }
+
+    int SeriesApproximation::getSkippedIterations() const noexcept
+    {
+        return m_skippedIterations;
+    }
+
+    void SeriesApproximation::evaluate(std::complex<double> dc, std::complex<double> &delta, std::complex<double> &dz) const
+    {
+        const int n = m_skippedIterations;
+        if (n == 0)
+        {
+            delta = std::complex<double>();
+            dz = std::complex<double>();
+            return;
+        }
+
+        const std::complex<double> u = dc / m_radius;
+        delta = evaluateDelta(n, u);
+
+        // d(delta)/d(dc) = (A + 2 B u + 3 C u^2) / radius, in terms of the scaled coefficients
+        dz = (m_a[n] + u * (2.0 * m_b[n] + 3.0 * m_c[n] * u)) / m_radius;
+    }
+
+    std::complex<double> SeriesApproximation::evaluateDelta(int n, std::complex<double> u) const
+    {
+        return u * (m_a[n] + u * (m_b[n] + u * m_c[n]));
+    }
+}
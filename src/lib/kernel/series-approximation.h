@@ -0,0 +1,73 @@
+#ifndef _MANDELBROT_LIB_KERNEL_SERIES_APPROXIMATION_H_
+#define _MANDELBROT_LIB_KERNEL_SERIES_APPROXIMATION_H_
+
+#include <complex>
+#include <vector>
+
+#include "kernel/reference-orbit.h"
+
+namespace mandelbrot
+{
+
+/**
+ * @class SeriesApproximation
+ * @brief Approximates the offset of a point's orbit from a \ref ReferenceOrbit as a truncated
+ *        power series in the offset dc of the point from the reference point:
+ *
+ *        delta(n) ~= A(n) * dc + B(n) * dc^2 + C(n) * dc^3
+ *
+ *        While the series remains accurate, every point in a frame can jump straight to
+ *        iteration n instead of iterating the perturbation from the start.
+ */
+class SeriesApproximation
+{
+public:
+    /// Constructs an approximation that does not skip any iterations
+    SeriesApproximation();
+
+    /**
+     * @brief Calculates the series coefficients along the reference orbit, and determines how many
+     *        iterations may be skipped by any point within the given distance of the reference point.
+     *        The number of iterations is bounded by the estimated truncation error of the series,
+     *        and then verified against probe points on the edge of the region.
+     * @param orbit Reference orbit
+     * @param halfWidth Largest real offset of a point from the reference point
+     * @param halfHeight Largest imaginary offset of a point from the reference point
+     */
+    void compute(const ReferenceOrbit &orbit, double halfWidth, double halfHeight);
+
+    /// Discards the coefficients, so no iterations are skipped
+    void reset();
+
+    /// Returns the number of iterations that may be skipped by each point
+    int getSkippedIterations() const noexcept;
+
+    /**
+     * @brief Evaluates the series at the skipped iteration count n, for a point with the given offset
+     * @param dc Offset of the point from the reference point
+     * @param delta Receives the offset of z(n) from Z(n)
+     * @param dz Receives the derivative of z(n)
+     */
+    void evaluate(std::complex<double> dc, std::complex<double> &delta, std::complex<double> &dz) const;
+
+private:
+    /// Evaluates the series with the coefficients of iteration n
+    std::complex<double> evaluateDelta(int n, std::complex<double> u) const;
+
+private:
+    /// Coefficients A(n), B(n) and C(n), pre-multiplied by the region radius to the power
+    /// of the term. This keeps them within range of a double regardless of the zoom depth.
+    std::vector<std::complex<double>> m_a;
+    std::vector<std::complex<double>> m_b;
+    std::vector<std::complex<double>> m_c;
+
+    /// Largest distance of a point from the reference point
+    double m_radius;
+
+    /// Number of iterations that can be skipped
+    int m_skippedIterations;
+};
+
+}
+
+#endif // _MANDELBROT_LIB_KERNEL_SERIES_APPROXIMATION_H_
@@ -1,281 +1,1660 @@
 #include "mandelbrot.h"
+#include "kernel/double-double.h"
+#include "kernel/perturbation-kernel.h"
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 #include <functional>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include <mpfr.h>
 
 #include <iostream>
 
-static mpfr_t mpLim;
-
 namespace mandelbrot
 {
-    static constexpr int NumThreads = 4;
+    static constexpr int DefaultTileSize = 64;
+
+    /// Rectangles of the Mariani-Silver subdivision with no more than this many pixels along a side
+    /// are iterated in full rather than split any further
+    static constexpr int MinSubdivisionSize = 6;
+
+    /// Largest number of iterations the single precision kernels can count exactly
+    static constexpr int MaxFloatIterations = 1 << 24;
+
+    /// Smallest scale at which perturbation is given the offsets of the pixels from the reference point as doubles,
+    /// and their derivatives are multiplied by the scale once they are out of the kernel. Beyond it, either would
+    /// leave the range of a double, so the offsets are given in pixels and iterated by perturbationRescaled()
+    static constexpr double MinAbsoluteOffsetScale = 1e-280;
+
+    /// Largest number of samples taken of a pixel along an edge
+    static constexpr int MaxSupersamples = 64;
+
+    /// Returns true if the pixel at (x, y) lies on the grid with the given spacing. No pixel lies on a grid with a spacing of 0
+    static bool isOnGrid(int x, int y, int spacing)
+    {
+        return spacing > 0 && x % spacing == 0 && y % spacing == 0;
+    }
+
+    /// Returns true if the pixel at (x, y) lies within the given region
+    static bool isInRegion(int x, int y, const Tile &region)
+    {
+        return x >= region.x && x < region.x + region.width && y >= region.y && y < region.y + region.height;
+    }
+
+    /// Returns a number in [0, 1) that looks random, but is the same for the same arguments, which keeps the samples
+    /// taken of a pixel in the same place from one frame to the next
+    static double hashToUnit(uint32_t a, uint32_t b, uint32_t c)
+    {
+        uint32_t h = a * 0x9E3779B1u ^ (b + 0x7F4A7C15u) * 0x85EBCA77u ^ (c + 0x165667B1u) * 0xC2B2AE3Du;
+        h ^= h >> 15;
+        h *= 0x2C1B3C6Du;
+        h ^= h >> 12;
+        h *= 0x297A2D39u;
+        h ^= h >> 15;
+        return h * (1.0 / 4294967296.0);
+    }
+
+    /// Returns the linear light intensity of each value of an sRGB color channel
+    static const std::array<float, 256> &getLinearIntensities()
+    {
+        static const std::array<float, 256> intensities = []() {
+            std::array<float, 256> values;
+            for (int i = 0; i < 256; ++i)
+            {
+                const double v = i / 255.0;
+                values[i] = static_cast<float>(v <= 0.04045 ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4));
+            }
+            return values;
+        }();
+        return intensities;
+    }
+
+    /// Returns the sRGB color channel of a linear light intensity in [0, 1]
+    static uint8_t toColorChannel(float intensity)
+    {
+        const float v = intensity <= 0.0031308f ? intensity * 12.92f : 1.055f * std::pow(intensity, 1.0f / 2.4f) - 0.055f;
+        return static_cast<uint8_t>(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f);
+    }
+
+    /// Returns the number of seconds that have passed since the given point in time
+    static double secondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /**
+     * @struct MandelbrotSet::TileData
+     * @brief Scratch space used by the render paths while calculating the escape time data of a tile.
+     *        The escape time data itself is stored in the given buffer, usually the iteration buffer of the frame.
+     */
+    struct MandelbrotSet::TileData
+    {
+        TileData(const Tile &t, double xOff, double yOff, IterationBuffer &buffer, MpfrWorkspace &ws, bool iteratedPrecisely) :
+            tile(t),
+            xOffset(xOff),
+            yOffset(yOff),
+            output(buffer),
+            columns(t.width),
+            rows(t.height),
+            computed(t.width * t.height, 0),
+            cRe(t.width),
+            cIm(t.height),
+            ddRe(),
+            ddIm(),
+            batch(),
+            glitchedPixels(),
+            storedIterations(0),
+            seriesSkippedIterations(0),
+            interiorSkippedIterations(0),
+            workspace(ws),
+            registers(ws),
+            precise(iteratedPrecisely)
+        {
+            mpfr_ptr *variables[] = { &zI, &zI2, &zR, &zR2, &dzI, &dzR, &dzTmp, &cImMp, &cReMp, &savedR, &savedI,
+                                      &scaleMp, &toleranceMp };
+            for (mpfr_ptr *variable : variables)
+                *variable = precise ? registers.take() : nullptr;
+
+            for (int x = 0; x < t.width; ++x)
+                columns[x] = t.x + x;
+            for (int y = 0; y < t.height; ++y)
+                rows[y] = t.y + y;
+        }
 
-    typedef void (MandelbrotSet::*MandelbrotPtr)(int, int, const double, const double);
+        /// Returns the coordinates of the pixel at the given index within the tile, relative to the output buffer
+        int frameX(int idx) const { return tile.x + idx % tile.width; }
+        int frameY(int idx) const { return tile.y + idx / tile.width; }
 
-    MandelbrotSet::MandelbrotSet() :
+        Tile tile;
+        double xOffset;
+        double yOffset;
+
+        /// Buffer the escape time data of the tile is stored in
+        IterationBuffer &output;
+
+        /// Position of each column and row of the tile within the frame, in pixels. The pixels of the frame lie at
+        /// whole positions, while the samples taken by supersampling lie in between them
+        std::vector<double> columns;
+        std::vector<double> rows;
+
+        /// Set for each pixel that has been calculated, or filled in by the Mariani-Silver algorithm
+        std::vector<char> computed;
+
+        /// Real components (or offsets from the reference point) of each column of the tile
+        std::vector<double> cRe;
+
+        /// Imaginary components (or offsets from the reference point) of each row of the tile
+        std::vector<double> cIm;
+
+        /// Real and imaginary components of each column and row of the tile, in double-double precision
+        std::vector<DoubleDouble> ddRe;
+        std::vector<DoubleDouble> ddIm;
+
+        /// Points gathered from anywhere in the tile, so they can be passed to a kernel together
+        struct
+        {
+            std::vector<double> cRe, cIm, zRe, zIm, dzRe, dzIm;
+            std::vector<DoubleDouble> ddRe, ddIm;
+            std::vector<int> iterations, indices;
+            std::unique_ptr<bool[]> glitched;
+            int capacity = 0;
+
+            EscapeTimeRow prepare(int count)
+            {
+                if (count > capacity)
+                {
+                    capacity = count;
+                    for (auto *v : { &cRe, &cIm, &zRe, &zIm, &dzRe, &dzIm })
+                        v->resize(count);
+                    ddRe.resize(count);
+                    ddIm.resize(count);
+                    iterations.resize(count);
+                    indices.resize(count);
+                    glitched.reset(new bool[count]);
+                }
+                return EscapeTimeRow { zRe.data(), zIm.data(), dzRe.data(), dzIm.data(), iterations.data() };
+            }
+        } batch;
+
+        /// Indices of the pixels that need to be iterated again against a different reference orbit
+        std::vector<int> glitchedPixels;
+
+        /// Iteration counts stored for the pixels of the tile, and the iterations skipped among them. Added to
+        /// the totals of the frame once the tile is complete
+        uint64_t storedIterations;
+        uint64_t seriesSkippedIterations;
+        uint64_t interiorSkippedIterations;
+
+        /// MPFR workspace of the worker thread rendering the tile, and the registers taken from it for as long as the
+        /// tile is being rendered
+        MpfrWorkspace &workspace;
+        MpfrWorkspace::Scope registers;
+
+        /// Set if the MPFR variables below have been taken from the workspace, or null otherwise
+        bool precise;
+        mpfr_ptr zI, zI2, zR, zR2, dzI, dzR, dzTmp, cImMp, cReMp, savedR, savedI;
+
+        /// Scale of the frame and periodicity tolerance, which may both be beyond the range of a double
+        mpfr_ptr scaleMp, toleranceMp;
+    };
+
+    MandelbrotSet::MandelbrotSet(int numThreads) :
         m_maxIterations(0),
         m_outputWidth(0),
         m_outputHeight(0),
+        m_preciseCenterX(),
+        m_preciseCenterY(),
+        m_preciseScale(),
         m_centerX(0.0),
         m_centerY(0.0),
         m_scale(0.0),
+        m_centerRemainderX(0.0),
+        m_centerRemainderY(0.0),
         m_colorStrategy(nullptr),
         m_outputDevice(nullptr),
-        m_threadPool(NumThreads),
+        m_tileSize(DefaultTileSize),
+        m_bandHeight(0),
+        m_threadPool(numThreads),
         m_mutex(),
         m_cv(),
-        m_threadsComplete(0)
+        m_tasksComplete(0),
+        m_escapeTimeKernel(selectEscapeTimeKernel(Precision::Double)),
+        m_floatEscapeTimeKernel(selectEscapeTimeKernel(Precision::Float)),
+        m_minimumPrecision(Precision::Double),
+        m_mpfrPrecision(0),
+        m_mpfrWorkspaces(m_threadPool),
+        m_deepZoomMode(DeepZoomMode::Perturbation),
+        m_renderStrategy(RenderStrategy::Exhaustive),
+        m_referenceOrbit(),
+        m_referenceCenterX(0.0),
+        m_referenceCenterY(0.0),
+        m_referenceIterations(0),
+        m_referencePrecision(0),
+        m_rescaledOffsets(false),
+        m_series(),
+        m_seriesApproximationEnabled(true),
+        m_seriesSkippedIterations(0),
+        m_interiorSkippedIterations(0),
+        m_storedIterations(0),
+        m_stats(),
+        m_statsEnabled(false),
+        m_tileStatsEnabled(true),
+        m_workerStats(),
+        m_iterationBuffer(),
+        m_iterationBufferValid(false),
+        m_histogram(),
+        m_histogramEnabled(false),
+        m_histogramValid(false),
+        m_retainedRegion{ 0, 0, 0, 0 },
+        m_supersamples(1),
+        m_colorThreshold(16),
+        m_iterationThreshold(-1),
+        m_edgeSamples(),
+        m_renderRun(nullptr),
+        m_cancellationToken(nullptr)
     {
-        mpfr_init2(mpLim, 128);
-        mpfr_set_d(mpLim, 4.0, MPFR_RNDN);
     }
 
     MandelbrotSet::~MandelbrotSet()
     {
-        mpfr_clear(mpLim);
     }
 
-    void MandelbrotSet::render()
+    void MandelbrotSet::render(const CancellationToken *cancellationToken)
+    {
+        renderPasses({ 1 }, nullptr, cancellationToken);
+    }
+
+    void MandelbrotSet::renderProgressive(const std::function<void()> &onPassComplete, const CancellationToken *cancellationToken)
+    {
+        renderPasses({ 8, 4, 1 }, onPassComplete, cancellationToken);
+    }
+
+    void MandelbrotSet::renderPasses(std::initializer_list<int> spacings, const std::function<void()> &onPassComplete,
+                                     const CancellationToken *cancellationToken)
     {
         if (!m_colorStrategy
                 || !m_outputDevice
                 || m_maxIterations == 0
                 || m_outputWidth <= 0
-                || m_outputHeight <= 4)
+                || m_outputHeight <= 0)
             return;
 
+        const auto frameStart = std::chrono::steady_clock::now();
         const double yOffset = (-1.0 * static_cast<double>(m_outputHeight)) / 2.0;
         const double xOffset = (-1.0 * static_cast<double>(m_outputWidth)) / 2.0;
 
-        m_threadsComplete.store(0);
+        m_seriesSkippedIterations.store(0);
+        m_interiorSkippedIterations.store(0);
+        m_storedIterations.store(0);
+        m_iterationBufferValid = false;
+        m_histogramValid = false;
+        m_histogramEnabled = m_colorStrategy->usesHistogram();
+        m_cancellationToken = cancellationToken;
+
+        // Each frame is iterated in the fastest arithmetic that tells its pixels apart. Single precision cannot
+        // count beyond 2^24 iterations, and frames beyond the reach of double precision are deep zoom frames.
+        // Perturbation iterates the pixels of those in double precision, whatever the precision the scale calls
+        // for. An iteration of it costs about a ninth of a double-double one, before the series approximation
+        // skips most of them, so the double-double kernel is only used with DeepZoomMode::Precise.
+        const Precision minimumPrecision = m_maxIterations > MaxFloatIterations
+                                         ? std::max(m_minimumPrecision, Precision::Double) : m_minimumPrecision;
+        Precision precision = selectPrecision(m_preciseScale, minimumPrecision);
+        RenderPath path = RenderPath::Direct;
+        if (precision > Precision::Double)
+        {
+            path = m_deepZoomMode == DeepZoomMode::Perturbation ? RenderPath::Perturbation : RenderPath::Precise;
+        }
+        if (path == RenderPath::Perturbation)
+            precision = Precision::Double;
+        m_rescaledOffsets = path == RenderPath::Perturbation && m_scale < MinAbsoluteOffsetScale;
+
+        beginStats(path);
+        m_stats.precision = precision;
+        m_mpfrPrecision = getPrecisionBits(Precision::Multi, m_preciseScale);
+
+        // The workers are idle between frames, so their registers can be resized to the precision of this one
+        if (path != RenderPath::Direct)
+        {
+            m_mpfrWorkspaces.forEach([this](MpfrWorkspace &workspace) {
+                workspace.setPrecision(m_mpfrPrecision);
+            });
+        }
+
+        RunPtr renderCallback = precision == Precision::Float ? &MandelbrotSet::renderSection<Precision::Float>
+                                                              : &MandelbrotSet::renderSection<Precision::Double>;
+        if (path != RenderPath::Direct)
+        {
+            if (path == RenderPath::Perturbation)
+            {
+                const auto referenceStart = std::chrono::steady_clock::now();
+                m_stats.mpfrPrecision = m_mpfrPrecision;
+
+                // Every pixel is iterated relative to the orbit of the center point. The orbit does not depend
+                // on the scale, so frames zooming in or out around the same center share it, as long as it
+                // was calculated with enough precision for the current scale.
+                if (m_referenceCenterX != m_preciseCenterX || m_referenceCenterY != m_preciseCenterY
+                        || m_referenceIterations != m_maxIterations || m_referencePrecision < m_mpfrPrecision)
+                {
+                    MpfrWorkspace &workspace = m_mpfrWorkspaces.local();
+                    MpfrWorkspace::Scope registers(workspace);
+                    mpfr_ptr refRe = registers.take(), refIm = registers.take();
+                    mpfr_set(refRe, m_preciseCenterX.get(), MPFR_RNDN);
+                    mpfr_set(refIm, m_preciseCenterY.get(), MPFR_RNDN);
+                    m_referenceOrbit.compute(refRe, refIm, m_maxIterations, workspace);
+
+                    m_referenceCenterX = m_preciseCenterX;
+                    m_referenceCenterY = m_preciseCenterY;
+                    m_referenceIterations = m_maxIterations;
+                    m_referencePrecision = m_mpfrPrecision;
+                }
+
+                // The coefficients of the series are scaled by powers of the size of the frame, which must be a double
+                if (m_seriesApproximationEnabled && !m_rescaledOffsets)
+                    m_series.compute(m_referenceOrbit, m_scale * -xOffset, m_scale * -yOffset);
+                else
+                    m_series.reset();
+
+                m_stats.referenceSeconds = secondsSince(referenceStart);
+                renderCallback = &MandelbrotSet::renderSectionPerturbation;
+            }
+            else if (precision == Precision::DoubleDouble)
+            {
+                renderCallback = &MandelbrotSet::renderSection<Precision::DoubleDouble>;
+            }
+            else
+            {
+                m_stats.mpfrPrecision = m_mpfrPrecision;
+                renderCallback = &MandelbrotSet::renderSectionPrecise;
+            }
+        }
+
+        m_renderRun = renderCallback;
+
+        // Frames taller than the band height are rendered a band of rows at a time, so that only the escape
+        // time data of one band is held in memory. Pixels kept from the previous frame by scroll() are only
+        // of use when the frame is rendered in one go. Histogram coloring needs the distribution of the whole
+        // frame before any of it is colored, so those frames are never banded. Neither are supersampled frames,
+        // whose edges run across the seams between bands, where pixels are compared to the rows on either side.
+        const bool banded = m_bandHeight > 0 && m_bandHeight < m_outputHeight && !m_histogramEnabled && m_supersamples == 1;
+        const int bandHeight = banded ? m_bandHeight : m_outputHeight;
+        const Tile retained = banded ? Tile { 0, 0, 0, 0 } : m_retainedRegion;
+
+        for (int bandY = 0; bandY < m_outputHeight && !isCancelled(); bandY += bandHeight)
+        {
+            const auto bandStart = std::chrono::steady_clock::now();
+            const int numRows = std::min(bandHeight, m_outputHeight - bandY);
+            if (m_iterationBuffer.getWidth() != m_outputWidth || m_iterationBuffer.getHeight() != numRows)
+                m_iterationBuffer.resize(m_outputWidth, numRows);
+
+            const double bandYOffset = yOffset + bandY;
+
+            // Each pass calculates the pixels on a finer grid than the one before, skipping those that
+            // were calculated by an earlier pass. Until the final pass, each calculated pixel is drawn
+            // as a block covering its neighbours that are yet to be calculated.
+            int previousSpacing = 0;
+            for (const int spacing : spacings)
+            {
+                const Pass pass { spacing, previousSpacing, retained };
+
+                // Tiles near the boundary of the set take far longer than the others, which is evened out
+                // by the threads of the pool stealing work from each other
+                const auto iterateStart = std::chrono::steady_clock::now();
+                if (m_histogramEnabled)
+                    m_histogram.reset(m_threadPool.getThreadCount() + 1, m_maxIterations);
+                forEachTile([this, xOffset, bandYOffset, renderCallback, &pass, bandY](const Tile &tile) {
+                    renderTile(tile, xOffset, bandYOffset, renderCallback, pass, bandY);
+                });
+                m_stats.iterateSeconds += secondsSince(iterateStart);
+
+                // The pixels of a cancelled frame are incomplete, and are neither colored nor written out.
+                // The retained region is left as it is, for the next frame to make use of.
+                if (isCancelled())
+                    break;
+
+                if (m_histogramEnabled)
+                    mergeHistogram();
+
+                colorFrame(pass, bandY, true);
 
-        MandelbrotPtr renderCallback = m_scale < 1e-16 ? &MandelbrotSet::renderSectionPrecise : &MandelbrotSet::renderSection;
+                // The edges of a frame cancelled while they were being sampled are missing some of their samples
+                if (spacing == 1 && !banded && !(m_supersamples > 1 && isCancelled()))
+                {
+                    m_iterationBufferValid = true;
+                    m_histogramValid = m_histogramEnabled;
+                    m_retainedRegion = Tile { 0, 0, 0, 0 };
+                }
+
+                if (onPassComplete)
+                    onPassComplete();
+
+                previousSpacing = spacing;
+            }
+
+            ++m_stats.numBands;
+            if (m_statsEnabled && m_tileStatsEnabled)
+                m_stats.bandSeconds.push_back(secondsSince(bandStart));
+        }
+
+        // The buffer of a banded frame only holds its last band, which is of no use to the next frame
+        if (banded)
+            invalidateIterationBuffer();
+
+        // Every stored iteration count includes the iterations skipped to arrive at it
+        m_stats.seriesSkippedIterations = m_seriesSkippedIterations.load();
+        m_stats.interiorSkippedIterations = m_interiorSkippedIterations.load();
+        m_stats.iterations = m_storedIterations.load() - m_stats.seriesSkippedIterations - m_stats.interiorSkippedIterations;
+        finishStats(frameStart);
+
+        m_cancellationToken = nullptr;
+    }
+
+    void MandelbrotSet::recolor(const CancellationToken *cancellationToken)
+    {
+        if (!m_iterationBufferValid)
+        {
+            render(cancellationToken);
+            return;
+        }
+
+        if (!m_colorStrategy || !m_outputDevice)
+            return;
+
+        // The escape time data is the one calculated by the last frame, along the same path
+        const auto frameStart = std::chrono::steady_clock::now();
+        beginStats(m_stats.path);
+        m_cancellationToken = cancellationToken;
 
-        // split work among each thread
-        const int rowsPerThread = m_outputHeight / NumThreads;
-        for (int i = 0; i < NumThreads; ++i)
+        // The histogram is only gathered by frames rendered for a strategy that uses it
+        if (m_colorStrategy->usesHistogram() && !m_histogramValid)
         {
-            int rowsToProcess = rowsPerThread;
-            if (i + 1 == NumThreads)
-                rowsToProcess += (m_outputHeight % NumThreads);
-            m_threadPool.post(std::bind(renderCallback, this, i * rowsPerThread, rowsToProcess, xOffset, yOffset));
+            const auto countStart = std::chrono::steady_clock::now();
+            m_histogram.reset(m_threadPool.getThreadCount() + 1, m_maxIterations);
+            forEachTile([this](const Tile &tile) {
+                countHistogram(tile, 1);
+            });
+            m_stats.histogramSeconds += secondsSince(countStart);
+
+            mergeHistogram();
+            m_histogramValid = true;
         }
 
+        colorFrame(Pass { 1, 0, Tile { 0, 0, 0, 0 } }, 0, false);
+
+        m_stats.numBands = 1;
+        finishStats(frameStart);
+        m_cancellationToken = nullptr;
+    }
+
+    void MandelbrotSet::forEachTask(int numTasks, const std::function<void(int)> &task)
+    {
+        m_tasksComplete = 0;
+
+        for (int i = 0; i < numTasks; ++i)
         {
-            std::unique_lock lock{m_mutex};
-            m_cv.wait(lock, [this](){
-                return m_threadsComplete == NumThreads;
+            m_threadPool.post([this, &task, i]() {
+                task(i);
+                onTaskComplete();
             });
         }
 
-        m_outputDevice->flush();
+        std::unique_lock lock{m_mutex};
+        m_cv.wait(lock, [this, numTasks](){
+            return m_tasksComplete == numTasks;
+        });
+    }
+
+    void MandelbrotSet::forEachTile(const std::function<void(const Tile &)> &task)
+    {
+        // Tiles are numbered in rows, top to bottom
+        const int width = m_iterationBuffer.getWidth();
+        const int height = m_iterationBuffer.getHeight();
+        const int tilesPerRow = (width + m_tileSize - 1) / m_tileSize;
+        const int numTiles = tilesPerRow * ((height + m_tileSize - 1) / m_tileSize);
+
+        forEachTask(numTiles, [this, &task, width, height, tilesPerRow](int i) {
+            const int x = (i % tilesPerRow) * m_tileSize, y = (i / tilesPerRow) * m_tileSize;
+            task(Tile { x, y, std::min(m_tileSize, width - x), std::min(m_tileSize, height - y) });
+        });
+    }
+
+    void MandelbrotSet::countHistogram(const Tile &tile, int spacing)
+    {
+        const int thread = m_threadPool.getCurrentThreadIndex();
+        const int histogram = thread < 0 ? m_threadPool.getThreadCount() : thread;
+
+        // Each pass counts every pixel on its grid, including those calculated by earlier passes
+        const int x0 = (tile.x + spacing - 1) / spacing * spacing;
+        for (int y = tile.y; y < tile.y + tile.height; ++y)
+        {
+            if (y % spacing != 0)
+                continue;
+
+            const int *row = m_iterationBuffer.getIterations() + m_iterationBuffer.indexOf(0, y);
+            if (spacing == 1)
+            {
+                m_histogram.add(histogram, row + tile.x, tile.width);
+                continue;
+            }
+
+            for (int x = x0; x < tile.x + tile.width; x += spacing)
+                m_histogram.add(histogram, row + x, 1);
+        }
+    }
+
+    void MandelbrotSet::mergeHistogram()
+    {
+        const auto mergeStart = std::chrono::steady_clock::now();
+
+        // The iteration counts are split into one range per thread, each summed over the histograms of every thread
+        const int maxIterations = m_histogram.getMaxIterations();
+        const int numRanges = std::max(1, std::min(m_threadPool.getThreadCount(), maxIterations / 4096));
+        forEachTask(numRanges, [this, maxIterations, numRanges](int i) {
+            const int first = static_cast<int>(static_cast<int64_t>(maxIterations) * i / numRanges);
+            const int last = static_cast<int>(static_cast<int64_t>(maxIterations) * (i + 1) / numRanges);
+            m_histogram.merge(first, last);
+        });
+        m_histogram.finish();
+        m_colorStrategy->setHistogram(m_histogram);
+
+        m_stats.histogramSeconds += secondsSince(mergeStart);
     }
 
-    void MandelbrotSet::renderSection(int startRow, int numRows, const double xOffset, const double yOffset)
+    void MandelbrotSet::scroll(int dx, int dy)
     {
-        constexpr double Limit = 4.0;
-        const int endIdx = std::min(m_outputHeight, startRow + numRows);
+        m_preciseCenterX.add(m_preciseScale, dx);
+        m_preciseCenterY.add(m_preciseScale, dy);
+        roundCenter();
+
+        // Region of the buffer holding valid pixels, in the coordinates of the previous frame
+        Tile region = m_retainedRegion;
+        if (m_iterationBufferValid)
+            region = Tile { 0, 0, m_iterationBuffer.getWidth(), m_iterationBuffer.getHeight() };
+
+        invalidateIterationBuffer();
+
+        // The pixel at (x, y) of the new frame is the pixel at (x + dx, y + dy) of the previous one
+        const int x0 = std::max(region.x - dx, 0);
+        const int y0 = std::max(region.y - dy, 0);
+        const int x1 = std::min(region.x + region.width - dx, m_iterationBuffer.getWidth());
+        const int y1 = std::min(region.y + region.height - dy, m_iterationBuffer.getHeight());
+        if (x0 >= x1 || y0 >= y1)
+            return;
 
-        for (int y = startRow; y < endIdx; ++y)
+        // Rows are moved in the order that keeps the source rows from being overwritten before they are moved
+        const int width = x1 - x0;
+        for (int i = 0; i < y1 - y0; ++i)
         {
-            double cIm = m_centerY + m_scale * (y + yOffset);
+            const int y = dy > 0 ? y0 + i : y1 - 1 - i;
+            const size_t dst = m_iterationBuffer.indexOf(x0, y);
+            const size_t src = m_iterationBuffer.indexOf(x0 + dx, y + dy);
+            std::memmove(m_iterationBuffer.getIterations() + dst, m_iterationBuffer.getIterations() + src, width * sizeof(int));
+            std::memmove(m_iterationBuffer.getModZ() + dst, m_iterationBuffer.getModZ() + src, width * sizeof(float));
+            std::memmove(m_iterationBuffer.getModDz() + dst, m_iterationBuffer.getModDz() + src, width * sizeof(float));
+        }
+
+        m_retainedRegion = Tile { x0, y0, width, y1 - y0 };
+    }
 
-            std::vector<color_t> rowColors;
-            rowColors.reserve(m_outputWidth);
+    void MandelbrotSet::renderTile(const Tile &tile, const double xOffset, const double yOffset, RunPtr renderRun,
+                                   const Pass &pass, int firstRow)
+    {
+        if (isCancelled())
+            return;
+
+        const auto tileStart = m_statsEnabled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+
+        TileData data(tile, xOffset, yOffset, m_iterationBuffer, m_mpfrWorkspaces.local(), renderRun == &MandelbrotSet::renderSectionPrecise);
+        prepareCoordinates(data, renderRun);
+
+        // Pixels calculated by earlier passes, or kept from the previous frame, are known already
+        auto isKnown = [&pass](int x, int y) {
+            return isOnGrid(x, y, pass.previousSpacing) || isInRegion(x, y, pass.retained);
+        };
+
+        if (m_renderStrategy == RenderStrategy::MarianiSilver && pass.spacing == 1)
+        {
+            // Known pixels serve as part of the borders, without being calculated again
+            for (int idx = 0; idx < tile.width * tile.height; ++idx)
+                data.computed[idx] = isKnown(data.frameX(idx), data.frameY(idx)) ? 1 : 0;
 
-            for (int x = 0; x < m_outputWidth; ++x)
+            subdivide(data, renderRun, 0, 0, tile.width - 1, tile.height - 1);
+        }
+        else
+        {
+            std::vector<int> indices;
+            indices.reserve(tile.width * tile.height);
+            for (int idx = 0; idx < tile.width * tile.height; ++idx)
             {
-                double cRe = m_centerX + m_scale * (x + xOffset);
+                const int x = data.frameX(idx), y = data.frameY(idx);
+                if (isOnGrid(x, y, pass.spacing) && !isKnown(x, y))
+                    indices.push_back(idx);
+            }
 
-                double zRe = 0.0,
-                       zIm = 0.0,
-                       zRe2 = 0.0,
-                       zIm2 = 0.0,
-                       dzRe = 0.0,
-                       dzIm = 0.0,
-                       dzTemp = 0.0;
-                int numIterations = 0;
-                do
-                {
-                    ++numIterations;
+            // The pixels are calculated a row's worth at a time, so that a cancelled frame is abandoned quickly
+            const int count = static_cast<int>(indices.size());
+            for (int first = 0; first < count && !isCancelled(); first += tile.width)
+                (this->*renderRun)(data, indices.data() + first, std::min(tile.width, count - first));
 
-                    // Derivative of z
-                    dzTemp = 2.0 * (zRe * dzRe - dzIm * zIm) + 1.0;
-                    dzIm = 2.0 * (zIm * dzRe + zRe * dzIm);
-                    dzRe = dzTemp;
+            resolveGlitches(data);
+        }
 
-                    dzTemp = zRe + zIm;
-                    zIm = (dzTemp * dzTemp) - zRe2 - zIm2;
-                    zIm += cIm;
-                    zRe = zRe2 - zIm2 + cRe;
-                    zRe2 = zRe * zRe;
-                    zIm2 = zIm * zIm;
+        // The totals of the frame are updated once per tile, rather than for every batch of pixels
+        m_storedIterations += data.storedIterations;
+        m_seriesSkippedIterations += data.seriesSkippedIterations;
+        m_interiorSkippedIterations += data.interiorSkippedIterations;
 
-                    if ((zRe2 + zIm2) > Limit)
-                        break;
+        // The pixels of the tile are still in the cache, which makes this the cheapest time to count them
+        if (m_histogramEnabled && !isCancelled())
+            countHistogram(tile, pass.spacing);
+
+        if (m_statsEnabled)
+        {
+            const uint64_t iterations = data.storedIterations - data.seriesSkippedIterations - data.interiorSkippedIterations;
+            recordTile(TileStats { Tile { tile.x, firstRow + tile.y, tile.width, tile.height }, pass.spacing,
+                                   RenderPhase::Iterate, 0, secondsSince(tileStart), iterations });
+        }
+    }
+
+    void MandelbrotSet::prepareCoordinates(TileData &data, RunPtr renderRun)
+    {
+        const Tile &tile = data.tile;
+        if (data.precise)
+        {
+            // Orbits of exterior points close to the boundary can linger near a cycle for a long time,
+            // so the tolerance of the periodicity check shrinks along with the pixels, as in getPeriodicityTolerance()
+            m_preciseScale.toMpfr(data.scaleMp);
+            mpfr_mul_d(data.toleranceMp, data.scaleMp, 1e-3, MPFR_RNDN);
+            if (mpfr_cmp_d(data.toleranceMp, PeriodicityTolerance) > 0)
+                mpfr_set_d(data.toleranceMp, PeriodicityTolerance, MPFR_RNDN);
+        }
+
+        // The perturbation kernel works with offsets from the reference point rather than absolute coordinates,
+        // which are counted in pixels for frames too deep for them to be doubles
+        const bool relative = renderRun == &MandelbrotSet::renderSectionPerturbation;
+        if (relative && m_rescaledOffsets)
+        {
+            for (int x = 0; x < tile.width; ++x)
+                data.cRe[x] = data.columns[x] + data.xOffset;
+            for (int y = 0; y < tile.height; ++y)
+                data.cIm[y] = data.rows[y] + data.yOffset;
+        }
+        else
+        {
+            for (int x = 0; x < tile.width; ++x)
+                data.cRe[x] = (relative ? 0.0 : m_centerX) + m_scale * (data.columns[x] + data.xOffset);
+            for (int y = 0; y < tile.height; ++y)
+                data.cIm[y] = (relative ? 0.0 : m_centerY) + m_scale * (data.rows[y] + data.yOffset);
+        }
+
+        // The offset of a pixel from the center is the product of two doubles, which a double-double holds exactly
+        if (renderRun == &MandelbrotSet::renderSection<Precision::DoubleDouble>)
+        {
+            data.ddRe.resize(tile.width);
+            data.ddIm.resize(tile.height);
+            for (int x = 0; x < tile.width; ++x)
+                data.ddRe[x] = DoubleDouble(m_centerX, m_centerRemainderX) + twoProduct(m_scale, data.columns[x] + data.xOffset);
+            for (int y = 0; y < tile.height; ++y)
+                data.ddIm[y] = DoubleDouble(m_centerY, m_centerRemainderY) + twoProduct(m_scale, data.rows[y] + data.yOffset);
+        }
+    }
+
+    void MandelbrotSet::storePixel(TileData &data, int idx, double zRe, double zIm, double dzRe, double dzIm, int iterations)
+    {
+        data.storedIterations += static_cast<uint64_t>(iterations);
+
+        // Coloring only depends on the magnitudes of z and dz. The derivative is made relative to the size
+        // of a pixel, so that it fits in a float at any zoom level. Offsets counted in pixels already are.
+        const size_t p = data.output.indexOf(data.frameX(idx), data.frameY(idx));
+        data.output.getIterations()[p] = iterations;
+        data.output.getModZ()[p] = static_cast<float>(std::hypot(zRe, zIm));
+        data.output.getModDz()[p] = static_cast<float>(m_rescaledOffsets ? std::hypot(dzRe, dzIm) : std::hypot(dzRe, dzIm) * m_scale);
+    }
+
+    template <Precision P>
+    void MandelbrotSet::renderSection(TileData &data, const int *indices, int count)
+    {
+        const int width = data.tile.width;
+        EscapeTimeRow escapeData = data.batch.prepare(count);
+        uint64_t skippedIterations = 0;
+
+        // Points inside the main cardioid or the period-2 bulb are known to be in the set, and are left
+        // out of the batch handed to the kernel. They are tested in the coordinates the kernel iterates
+        int batchCount = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            const double cRe = data.cRe[indices[i] % width];
+            const double cIm = data.cIm[indices[i] / width];
+            bool inSet;
+            if constexpr (P == Precision::DoubleDouble)
+                inSet = isInMainCardioidOrBulb(data.ddRe[indices[i] % width], data.ddIm[indices[i] / width]);
+            else
+                inSet = isInMainCardioidOrBulb(cRe, cIm);
+
+            if (inSet)
+            {
+                storePixel(data, indices[i], 0.0, 0.0, 0.0, 0.0, m_maxIterations);
+                skippedIterations += static_cast<uint64_t>(m_maxIterations);
+                continue;
+            }
+
+            if constexpr (P == Precision::DoubleDouble)
+            {
+                data.batch.ddRe[batchCount] = data.ddRe[indices[i] % width];
+                data.batch.ddIm[batchCount] = data.ddIm[indices[i] / width];
+            }
+            else
+            {
+                data.batch.cRe[batchCount] = cRe;
+                data.batch.cIm[batchCount] = cIm;
+            }
+            data.batch.indices[batchCount] = indices[i];
+            ++batchCount;
+        }
+
+        // As with MPFR, the tolerance of the periodicity check shrinks along with the pixels
+        const double tolerance = getPeriodicityTolerance(P, m_scale);
+        if constexpr (P == Precision::Float)
+        {
+            skippedIterations += m_floatEscapeTimeKernel(data.batch.cRe.data(), data.batch.cIm.data(), batchCount, m_maxIterations,
+                                                         tolerance, escapeData);
+        }
+        else if constexpr (P == Precision::Double)
+        {
+            skippedIterations += m_escapeTimeKernel(data.batch.cRe.data(), data.batch.cIm.data(), batchCount, m_maxIterations,
+                                                    tolerance, escapeData);
+        }
+        else
+        {
+            skippedIterations += escapeTimeDoubleDouble(data.batch.ddRe.data(), data.batch.ddIm.data(), batchCount,
+                                                        m_maxIterations, tolerance, escapeData);
+        }
+        data.interiorSkippedIterations += skippedIterations;
+
+        for (int i = 0; i < batchCount; ++i)
+        {
+            storePixel(data, data.batch.indices[i], escapeData.zRe[i], escapeData.zIm[i],
+                       escapeData.dzRe[i], escapeData.dzIm[i], escapeData.iterations[i]);
+        }
+    }
+
+    void MandelbrotSet::renderSectionPrecise(TileData &data, const int *indices, int count)
+    {
+        mpfr_ptr zI = data.zI, zI2 = data.zI2, zR = data.zR, zR2 = data.zR2,
+                 dzI = data.dzI, dzR = data.dzR, dzTmp = data.dzTmp,
+                 cIm = data.cImMp, cRe = data.cReMp,
+                 savedR = data.savedR, savedI = data.savedI,
+                 scale = data.scaleMp, tolerance = data.toleranceMp;
+        uint64_t skippedIterations = 0;
+
+        for (int n = 0; n < count && !isCancelled(); ++n)
+        {
+            const int i = indices[n];
+
+            mpfr_set_d(cIm, data.rows[i / data.tile.width], MPFR_RNDN);
+            mpfr_add_d(cIm, cIm, data.yOffset, MPFR_RNDN);
+            mpfr_mul(cIm, cIm, scale, MPFR_RNDN);
+            mpfr_add(cIm, cIm, m_preciseCenterY.get(), MPFR_RNDN);
+
+            mpfr_set_d(cRe, data.columns[i % data.tile.width], MPFR_RNDN);
+            mpfr_add_d(cRe, cRe, data.xOffset, MPFR_RNDN);
+            mpfr_mul(cRe, cRe, scale, MPFR_RNDN);
+            mpfr_add(cRe, cRe, m_preciseCenterX.get(), MPFR_RNDN);
+
+            // Main cardioid: with q = (x - 1/4)^2 + y^2, inside if q * (q + x - 1/4) <= y^2 / 4
+            mpfr_sub_d(zR, cRe, 0.25, MPFR_RNDN);
+            mpfr_sqr(zI2, cIm, MPFR_RNDN);
+            mpfr_sqr(zR2, zR, MPFR_RNDN);
+            mpfr_add(zR2, zR2, zI2, MPFR_RNDN);
+            mpfr_add(zI, zR2, zR, MPFR_RNDN);
+            mpfr_mul(zI, zI, zR2, MPFR_RNDN);
+            mpfr_div_2si(zR, zI2, 2, MPFR_RNDN);
+            bool inSet = mpfr_cmp(zI, zR) <= 0;
+
+            // Period-2 bulb: (x + 1)^2 + y^2 <= 1/16
+            if (!inSet)
+            {
+                mpfr_add_si(zR, cRe, 1, MPFR_RNDN);
+                mpfr_sqr(zR, zR, MPFR_RNDN);
+                mpfr_add(zR, zR, zI2, MPFR_RNDN);
+                inSet = mpfr_cmp_d(zR, 0.0625) <= 0;
+            }
+
+            const size_t p = data.output.indexOf(data.frameX(i), data.frameY(i));
+            if (inSet)
+            {
+                data.output.getIterations()[p] = m_maxIterations;
+                data.output.getModZ()[p] = 0.0f;
+                data.output.getModDz()[p] = 0.0f;
+                data.storedIterations += static_cast<uint64_t>(m_maxIterations);
+                skippedIterations += static_cast<uint64_t>(m_maxIterations);
+                continue;
+            }
+
+            mpfr_set_zero(zI, 0);
+            mpfr_set_zero(zI2, 0);
+            mpfr_set_zero(zR, 0);
+            mpfr_set_zero(zR2, 0);
+            mpfr_set_zero(dzI, 0);
+            mpfr_set_zero(dzR, 0);
+            mpfr_set_zero(dzTmp, 0);
+            mpfr_set_zero(savedR, 0);
+            mpfr_set_zero(savedI, 0);
+
+            int numIterations = 0;
+            unsigned savePeriod = 1, sinceSave = 0;
+            do
+            {
+                ++numIterations;
+
+                // Derivative of z
+                // dzTmp = (zR * dzR) - (dzI * zI)
+                mpfr_fmms(dzTmp, zR, dzR, dzI, zI, MPFR_RNDN);
+                // dzR = 2.0 * ((zR * dzR) - (dzI * zI)) + 1.0;
+                mpfr_mul_si(dzTmp, dzTmp, 2, MPFR_RNDN);
 
-                } while (numIterations < m_maxIterations);
+                // dzI = 2.0 * (zI * dzR + zR * dzI);
+                mpfr_fmma(dzI, zI, dzR, zR, dzI, MPFR_RNDN);
+                mpfr_mul_d(dzI, dzI, 2.0, MPFR_RNDN);
+                mpfr_add_si(dzR, dzTmp, 1, MPFR_RNDN);
 
-                /*
-                int numIterations = 0;
-                do
+                //zI = ((zR+zI)^2) - zR2 - zI2 + cI
+                mpfr_add(dzTmp, zR, zI, MPFR_RNDN);
+                mpfr_sqr(zI, dzTmp, MPFR_RNDN);
+                mpfr_sub(zI, zI, zR2, MPFR_RNDN);
+                mpfr_sub(zI, zI, zI2, MPFR_RNDN);
+                mpfr_add(zI, zI, cIm, MPFR_RNDN);
+
+                //zR = zR2 - zI2 + cR
+                mpfr_sub(zR, zR2, zI2, MPFR_RNDN);
+                mpfr_add(zR, zR, cRe, MPFR_RNDN);
+
+                mpfr_sqr(zR2, zR, MPFR_RNDN);
+                mpfr_sqr(zI2, zI, MPFR_RNDN);
+
+                mpfr_add(dzTmp, zR2, zI2, MPFR_RNDN);
+                if (mpfr_cmp_ui(dzTmp, 4) > 0)
+                    break;
+
+                // Brent's cycle detection, as in the double precision kernels
+                mpfr_sub(dzTmp, zR, savedR, MPFR_RNDN);
+                mpfr_abs(dzTmp, dzTmp, MPFR_RNDN);
+                if (mpfr_cmp(dzTmp, tolerance) < 0)
                 {
-                    ++numIterations;
-
-                    //zDerivative
-                    nextDzRe = 2.0 * (zRe * dzRe - dzIm * zIm) + 1.0;
-                    nextDzIm = 2.0 * (zIm * dzRe + zRe * dzIm);
-                    dzRe = nextDzRe;
-                    dzIm = nextDzIm;
-
-                    //z
-                    nextZRe = zRe2 - zIm2 + cRe;
-                    nextZIm = 2.0 * (zIm * zRe) + cIm;
-                    zRe = nextZRe;
-                    zIm = nextZIm;
-
-                    zRe2 = zRe * zRe;
-                    zIm2 = zIm * zIm;
-                    if ((zRe2 + zIm2) > Limit)
+                    mpfr_sub(dzTmp, zI, savedI, MPFR_RNDN);
+                    mpfr_abs(dzTmp, dzTmp, MPFR_RNDN);
+                    if (mpfr_cmp(dzTmp, tolerance) < 0)
+                    {
+                        skippedIterations += static_cast<uint64_t>(m_maxIterations - numIterations);
+                        numIterations = m_maxIterations;
                         break;
-                } while (numIterations < m_maxIterations);
-                */
+                    }
+                }
 
-                if (numIterations < m_maxIterations)
+                if (++sinceSave == savePeriod)
                 {
-                    rowColors.emplace_back(m_colorStrategy->getColor(
-                                std::complex<double>(zRe, zIm),
-                                std::complex<double>(dzRe, dzIm),
-                                m_scale,
-                                numIterations,
-                                m_maxIterations));
+                    mpfr_set(savedR, zR, MPFR_RNDN);
+                    mpfr_set(savedI, zI, MPFR_RNDN);
+                    savePeriod *= 2;
+                    sinceSave = 0;
                 }
-                else
+            } while (numIterations < m_maxIterations);
+
+            // The derivative is scaled down before leaving MPFR, as it may not fit in a double on its own
+            mpfr_mul(dzR, dzR, scale, MPFR_RNDN);
+            mpfr_mul(dzI, dzI, scale, MPFR_RNDN);
+            const double scaledDzRe = mpfr_get_d(dzR, MPFR_RNDN);
+            const double scaledDzIm = mpfr_get_d(dzI, MPFR_RNDN);
+
+            data.output.getIterations()[p] = numIterations;
+            data.output.getModZ()[p] = static_cast<float>(std::hypot(mpfr_get_d(zR, MPFR_RNDN), mpfr_get_d(zI, MPFR_RNDN)));
+            data.output.getModDz()[p] = static_cast<float>(std::hypot(scaledDzRe, scaledDzIm));
+            data.storedIterations += static_cast<uint64_t>(numIterations);
+        }
+
+        data.interiorSkippedIterations += skippedIterations;
+    }
+
+    void MandelbrotSet::renderSectionPerturbation(TileData &data, const int *indices, int count)
+    {
+        const int width = data.tile.width;
+        EscapeTimeRow escapeData = data.batch.prepare(count);
+        for (int i = 0; i < count; ++i)
+        {
+            data.batch.cRe[i] = data.cRe[indices[i] % width];
+            data.batch.cIm[i] = data.cIm[indices[i] / width];
+        }
+
+        data.seriesSkippedIterations += static_cast<uint64_t>(m_series.getSkippedIterations()) * count;
+
+        if (m_rescaledOffsets)
+        {
+            perturbationRescaled(m_referenceOrbit, m_preciseScale, data.batch.cRe.data(), data.batch.cIm.data(), count,
+                                 m_maxIterations, escapeData, data.batch.glitched.get());
+        }
+        else
+        {
+            perturbationScalar(m_referenceOrbit, &m_series, data.batch.cRe.data(), data.batch.cIm.data(), count,
+                               m_maxIterations, escapeData, data.batch.glitched.get());
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            storePixel(data, indices[i], escapeData.zRe[i], escapeData.zIm[i],
+                       escapeData.dzRe[i], escapeData.dzIm[i], escapeData.iterations[i]);
+            if (data.batch.glitched[i])
+                data.glitchedPixels.push_back(indices[i]);
+        }
+    }
+
+    void MandelbrotSet::resolveGlitches(TileData &data)
+    {
+        std::vector<int> &glitchedPixels = data.glitchedPixels;
+        if (glitchedPixels.empty())
+            return;
+
+        // Glitched pixels restart from the first iteration against their new reference, so they do not
+        // benefit from the series approximation of the center orbit. The iterations skipped on their first
+        // attempt were not performed either, and are taken out of their stored counts.
+        const uint64_t glitchSkipped = static_cast<uint64_t>(m_series.getSkippedIterations()) * glitchedPixels.size();
+        data.seriesSkippedIterations -= glitchSkipped;
+        data.storedIterations -= glitchSkipped;
+
+        const Tile &tile = data.tile;
+        const float *modZ = data.output.getModZ();
+        ReferenceOrbit orbit;
+        MpfrWorkspace::Scope registers(data.workspace);
+        mpfr_ptr refRe = registers.take(), refIm = registers.take(), refOffset = registers.take();
+        if (m_rescaledOffsets)
+            m_preciseScale.toMpfr(refOffset);
+
+        // Glitched pixels are iterated again relative to a new reference point picked among them, until none
+        // are left. The new reference point can never glitch against its own orbit, so this always terminates.
+        std::vector<int> stillGlitched;
+        while (!glitchedPixels.empty() && !isCancelled())
+        {
+            // Points near the center of a glitch pass closest to zero, making them the best candidates
+            const int refIdx = *std::min_element(glitchedPixels.begin(), glitchedPixels.end(), [&data, modZ](int a, int b) {
+                return modZ[data.output.indexOf(data.frameX(a), data.frameY(a))]
+                        < modZ[data.output.indexOf(data.frameX(b), data.frameY(b))];
+            });
+            const double refDcRe = data.cRe[refIdx % tile.width];
+            const double refDcIm = data.cIm[refIdx / tile.width];
+
+            if (m_rescaledOffsets)
+            {
+                mpfr_mul_d(refRe, refOffset, refDcRe, MPFR_RNDN);
+                mpfr_add(refRe, refRe, m_preciseCenterX.get(), MPFR_RNDN);
+                mpfr_mul_d(refIm, refOffset, refDcIm, MPFR_RNDN);
+                mpfr_add(refIm, refIm, m_preciseCenterY.get(), MPFR_RNDN);
+            }
+            else
+            {
+                mpfr_set(refRe, m_preciseCenterX.get(), MPFR_RNDN);
+                mpfr_add_d(refRe, refRe, refDcRe, MPFR_RNDN);
+                mpfr_set(refIm, m_preciseCenterY.get(), MPFR_RNDN);
+                mpfr_add_d(refIm, refIm, refDcIm, MPFR_RNDN);
+            }
+            orbit.compute(refRe, refIm, m_maxIterations, data.workspace);
+
+            const int count = static_cast<int>(glitchedPixels.size());
+            EscapeTimeRow escapeData = data.batch.prepare(count);
+            for (int i = 0; i < count; ++i)
+            {
+                data.batch.cRe[i] = data.cRe[glitchedPixels[i] % tile.width] - refDcRe;
+                data.batch.cIm[i] = data.cIm[glitchedPixels[i] / tile.width] - refDcIm;
+            }
+
+            if (m_rescaledOffsets)
+            {
+                perturbationRescaled(orbit, m_preciseScale, data.batch.cRe.data(), data.batch.cIm.data(), count,
+                                     m_maxIterations, escapeData, data.batch.glitched.get());
+            }
+            else
+            {
+                perturbationScalar(orbit, nullptr, data.batch.cRe.data(), data.batch.cIm.data(), count,
+                                   m_maxIterations, escapeData, data.batch.glitched.get());
+            }
+
+            stillGlitched.clear();
+            for (int i = 0; i < count; ++i)
+            {
+                storePixel(data, glitchedPixels[i], escapeData.zRe[i], escapeData.zIm[i],
+                           escapeData.dzRe[i], escapeData.dzIm[i], escapeData.iterations[i]);
+                if (data.batch.glitched[i])
+                    stillGlitched.push_back(glitchedPixels[i]);
+            }
+            glitchedPixels.swap(stillGlitched);
+        }
+    }
+
+    void MandelbrotSet::renderPixels(TileData &data, RunPtr renderRun, std::vector<int> &indices)
+    {
+        // Pixels shared with a neighbouring rectangle may have been calculated already
+        indices.erase(std::remove_if(indices.begin(), indices.end(), [&data](int idx) {
+            return data.computed[idx] != 0;
+        }), indices.end());
+
+        std::sort(indices.begin(), indices.end());
+        indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+
+        if (indices.empty())
+            return;
+
+        for (int idx : indices)
+            data.computed[idx] = 1;
+
+        (this->*renderRun)(data, indices.data(), static_cast<int>(indices.size()));
+        resolveGlitches(data);
+    }
+
+    void MandelbrotSet::subdivide(TileData &data, RunPtr renderRun, int x0, int y0, int x1, int y1)
+    {
+        if (isCancelled())
+            return;
+
+        const int width = data.tile.width;
+        int *iterations = data.output.getIterations();
+        float *modZ = data.output.getModZ();
+        float *modDz = data.output.getModDz();
+        auto at = [&data](int x, int y) {
+            return data.output.indexOf(data.tile.x + x, data.tile.y + y);
+        };
+
+        // The border of the rectangle is calculated as a single batch, to make full use of the vectorized kernels
+        std::vector<int> indices;
+        for (int x = x0; x <= x1; ++x)
+        {
+            indices.push_back(y0 * width + x);
+            indices.push_back(y1 * width + x);
+        }
+        for (int y = y0 + 1; y < y1; ++y)
+        {
+            indices.push_back(y * width + x0);
+            indices.push_back(y * width + x1);
+        }
+        renderPixels(data, renderRun, indices);
+
+        if (x1 - x0 < 2 || y1 - y0 < 2)
+            return;
+
+        if (x1 - x0 < MinSubdivisionSize || y1 - y0 < MinSubdivisionSize)
+        {
+            indices.clear();
+            for (int y = y0 + 1; y < y1; ++y)
+            {
+                for (int x = x0 + 1; x < x1; ++x)
+                    indices.push_back(y * width + x);
+            }
+            renderPixels(data, renderRun, indices);
+            return;
+        }
+
+        const int borderIterations = iterations[at(x0, y0)];
+        bool uniform = true;
+        for (int x = x0; x <= x1 && uniform; ++x)
+            uniform = iterations[at(x, y0)] == borderIterations && iterations[at(x, y1)] == borderIterations;
+        for (int y = y0 + 1; y < y1 && uniform; ++y)
+            uniform = iterations[at(x0, y)] == borderIterations && iterations[at(x1, y)] == borderIterations;
+
+        if (uniform)
+        {
+            // The border shares a single iteration count, so the inside is filled in without iterating it.
+            // Coloring only depends on the magnitudes of z and dz, which are interpolated between the left
+            // and right edges to keep smooth color strategies continuous. Pixels that are already known, such
+            // as those of an earlier pass, keep their own data.
+            for (int y = y0 + 1; y < y1; ++y)
+            {
+                const size_t left = at(x0, y);
+                const size_t right = at(x1, y);
+
+                for (int x = x0 + 1; x < x1; ++x)
                 {
-                    rowColors.emplace_back(m_colorStrategy->getColorInSet());
+                    if (data.computed[y * width + x])
+                        continue;
+
+                    const size_t p = at(x, y);
+                    const float t = static_cast<float>(x - x0) / (x1 - x0);
+                    modZ[p] = modZ[left] + t * (modZ[right] - modZ[left]);
+                    modDz[p] = modDz[left] + t * (modDz[right] - modDz[left]);
+                    iterations[p] = borderIterations;
+                    data.computed[y * width + x] = 1;
                 }
             }
+            return;
+        }
 
-            m_outputDevice->write(0, y, std::move(rowColors));
+        // Split along the longer side. Both halves share the dividing line as part of their border
+        if (x1 - x0 >= y1 - y0)
+        {
+            const int mid = (x0 + x1) / 2;
+            subdivide(data, renderRun, x0, y0, mid, y1);
+            subdivide(data, renderRun, mid, y0, x1, y1);
+        }
+        else
+        {
+            const int mid = (y0 + y1) / 2;
+            subdivide(data, renderRun, x0, y0, x1, mid);
+            subdivide(data, renderRun, x0, mid, x1, y1);
         }
+    }
 
-        m_threadsComplete++;
-        m_cv.notify_one();
+    bool MandelbrotSet::isCancelled() const noexcept
+    {
+        return m_cancellationToken && m_cancellationToken->isCancelled();
     }
 
-    void MandelbrotSet::renderSectionPrecise(int startRow, int numRows, const double xOffset, const double yOffset)
+    void MandelbrotSet::onTaskComplete()
     {
-        const int endIdx = std::min(m_outputHeight, startRow + numRows);
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            ++m_tasksComplete;
+        }
+        m_cv.notify_one();
+    }
 
-        mpfr_t zI, zI2, zR, zR2, dzI, dzR, dzTmp, cIm, cRe;
-        mpfr_inits2(128, zI, zI2, zR, zR2, dzI, dzR, dzTmp, cIm, cRe, (mpfr_ptr)0);
+    void MandelbrotSet::colorFrame(const Pass &pass, int firstRow, bool sampleEdges)
+    {
+        const auto outputStart = std::chrono::steady_clock::now();
+        m_outputDevice->beginRows(firstRow, m_iterationBuffer.getHeight());
+        m_stats.outputSeconds += secondsSince(outputStart);
 
-        for (int y = startRow; y < endIdx; ++y)
+        // Each tile keeps the samples of its own edges, replacing those of the frame before
+        if (sampleEdges && pass.spacing == 1 && m_supersamples > 1)
         {
-            mpfr_set_zero(cIm, 0);
-            mpfr_add_si(cIm, cIm, y, MPFR_RNDN);
-            mpfr_add_d(cIm, cIm, yOffset, MPFR_RNDN);
-            mpfr_mul_d(cIm, cIm, m_scale, MPFR_RNDN);
-            mpfr_add_d(cIm, cIm, m_centerY, MPFR_RNDN);
+            const int tilesPerRow = (m_iterationBuffer.getWidth() + m_tileSize - 1) / m_tileSize;
+            const int tilesPerColumn = (m_iterationBuffer.getHeight() + m_tileSize - 1) / m_tileSize;
+            m_edgeSamples.resize(static_cast<size_t>(tilesPerRow) * tilesPerColumn);
+        }
+
+        const auto colorStart = std::chrono::steady_clock::now();
+        forEachTile([this, &pass, firstRow, sampleEdges](const Tile &tile) {
+            colorTile(tile, pass, firstRow, sampleEdges);
+        });
+        m_stats.colorSeconds += secondsSince(colorStart);
 
-            std::vector<color_t> rowColors;
-            rowColors.reserve(m_outputWidth);
+        const auto flushStart = std::chrono::steady_clock::now();
+        m_outputDevice->flush();
+        m_stats.flushSeconds += secondsSince(flushStart);
+    }
+
+    void MandelbrotSet::colorTile(const Tile &tile, const Pass &pass, int firstRow, bool sampleEdges)
+    {
+        const auto tileStart = m_statsEnabled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        uint64_t escapedPixels = 0;
+        double outputSeconds = 0.0;
 
-            for (int x = 0; x < m_outputWidth; ++x)
+        const int spacing = pass.spacing;
+        const int *iterations = m_iterationBuffer.getIterations();
+        const float *modZ = m_iterationBuffer.getModZ();
+        const float *modDz = m_iterationBuffer.getModDz();
+
+        std::vector<color_t> rowColors;
+
+        // Frames supersampled along their edges are colored a tile at a time, along with the pixels around the
+        // tile, so that its edges are found and sampled before any of its rows are written out
+        const bool supersampled = spacing == 1 && m_supersamples > 1 && m_renderRun;
+        std::vector<color_t> tileColors;
+        Tile region = tile;
+        uint64_t supersampledPixels = 0;
+        if (supersampled)
+        {
+            const int x0 = std::max(tile.x - 1, 0), y0 = std::max(tile.y - 1, 0);
+            const int x1 = std::min(tile.x + tile.width + 1, m_iterationBuffer.getWidth());
+            const int y1 = std::min(tile.y + tile.height + 1, m_iterationBuffer.getHeight());
+            region = Tile { x0, y0, x1 - x0, y1 - y0 };
+            tileColors.resize(static_cast<size_t>(region.width) * region.height);
+            for (int y = y0; y < y1; ++y)
             {
-                mpfr_set_zero(cRe, 0);
-                mpfr_add_si(cRe, cRe, x, MPFR_RNDN);
-                mpfr_add_d(cRe, cRe, xOffset, MPFR_RNDN);
-                mpfr_mul_d(cRe, cRe, m_scale, MPFR_RNDN);
-                mpfr_add_d(cRe, cRe, m_centerX, MPFR_RNDN);
+                const size_t first = m_iterationBuffer.indexOf(x0, y);
+                m_colorStrategy->getColors(modZ + first, modDz + first, iterations + first, region.width, m_maxIterations,
+                                           tileColors.data() + static_cast<size_t>(y - y0) * region.width);
+            }
 
-                mpfr_set_zero(zI, 0);
-                mpfr_set_zero(zI2, 0);
-                mpfr_set_zero(zR, 0);
-                mpfr_set_zero(zR2, 0);
-                mpfr_set_zero(dzI, 0);
-                mpfr_set_zero(dzR, 0);
-                mpfr_set_zero(dzTmp, 0);
+            const int tilesPerRow = (m_iterationBuffer.getWidth() + m_tileSize - 1) / m_tileSize;
+            EdgeSamples &samples = m_edgeSamples[static_cast<size_t>(tile.y / m_tileSize) * tilesPerRow + tile.x / m_tileSize];
+            if (sampleEdges)
+                supersampleTile(tile, region, tileColors, firstRow, samples);
 
-                int numIterations = 0;
-                do
-                {
-                    ++numIterations;
-
-                    // Derivative of z
-                    // dzTmp = (zR * dzR) - (dzI * zI)
-                    mpfr_fmms(dzTmp, zR, dzR, dzI, zI, MPFR_RNDN);
-                    // dzR = 2.0 * ((zR * dzR) - (dzI * zI)) + 1.0;
-                    mpfr_mul_si(dzTmp, dzTmp, 2, MPFR_RNDN);
-
-                    // dzI = 2.0 * (zI * dzR + zR * dzI);
-                    mpfr_fmma(dzI, zI, dzR, zR, dzI, MPFR_RNDN);
-                    mpfr_mul_d(dzI, dzI, 2.0, MPFR_RNDN);
-                    mpfr_add_si(dzR, dzTmp, 1, MPFR_RNDN);
-
-                    //zI = ((zR+zI)^2) - zR2 - zI2 + cI
-                    mpfr_add(dzTmp, zR, zI, MPFR_RNDN);
-                    mpfr_sqr(zI, dzTmp, MPFR_RNDN);
-                    mpfr_sub(zI, zI, zR2, MPFR_RNDN);
-                    mpfr_sub(zI, zI, zI2, MPFR_RNDN);
-                    mpfr_add(zI, zI, cIm, MPFR_RNDN);
-
-                    //zR = zR2 - zI2 + cR
-                    mpfr_sub(zR, zR2, zI2, MPFR_RNDN);
-                    mpfr_add(zR, zR, cRe, MPFR_RNDN);
-
-                    mpfr_sqr(zR2, zR, MPFR_RNDN);
-                    mpfr_sqr(zI2, zI, MPFR_RNDN);
-
-                    mpfr_add(dzTmp, zR2, zI2, MPFR_RNDN);
-                    if (mpfr_greater_p(dzTmp, mpLim))
-                        break;
-                } while (numIterations < m_maxIterations);
+            supersampledPixels = blendSamples(region, tileColors, samples);
+        }
+
+        // Escape time data of the pixels of a row that takes on the data of other pixels
+        std::vector<int> rowIterations;
+        std::vector<float> rowModZ, rowModDz;
+
+        for (int y = tile.y; y < tile.y + tile.height; ++y)
+        {
+            // Colors are written straight into the buffer of the output device where it allows it, and
+            // passed to it a row at a time otherwise
+            color_t *row = m_outputDevice->getRow(firstRow + y);
+            color_t *out;
+            if (row)
+            {
+                out = row + tile.x;
+            }
+            else
+            {
+                rowColors.resize(tile.width);
+                out = rowColors.data();
+            }
 
-                if (numIterations < m_maxIterations)
+            // Every pixel of the final pass has its own escape time data. Until then, pixels that have not been
+            // calculated yet take on the data of the nearest calculated pixel above and to the left of them.
+            const size_t first = m_iterationBuffer.indexOf(tile.x, y);
+            const int *rowIters = iterations + first;
+            const float *rowZ = modZ + first;
+            const float *rowDz = modDz + first;
+            if (spacing > 1)
+            {
+                rowIterations.resize(tile.width);
+                rowModZ.resize(tile.width);
+                rowModDz.resize(tile.width);
+                for (int x = tile.x; x < tile.x + tile.width; ++x)
                 {
-                    rowColors.emplace_back(m_colorStrategy->getColorPrecise(
-                                zR, zI,
-                                dzR, dzI,
-                                m_scale,
-                                numIterations,
-                                m_maxIterations));
+                    const size_t p = isInRegion(x, y, pass.retained)
+                            ? m_iterationBuffer.indexOf(x, y)
+                            : m_iterationBuffer.indexOf(x - x % spacing, y - y % spacing);
+                    rowIterations[x - tile.x] = iterations[p];
+                    rowModZ[x - tile.x] = modZ[p];
+                    rowModDz[x - tile.x] = modDz[p];
                 }
-                else
+                rowIters = rowIterations.data();
+                rowZ = rowModZ.data();
+                rowDz = rowModDz.data();
+            }
+
+            if (supersampled)
+            {
+                const color_t *colors = tileColors.data() + static_cast<size_t>(y - region.y) * region.width + tile.x - region.x;
+                std::copy(colors, colors + tile.width, out);
+            }
+            else
+            {
+                // The strategy is looked up once per row, and colors the whole row with its calls bound at compile time
+                m_colorStrategy->getColors(rowZ, rowDz, rowIters, tile.width, m_maxIterations, out);
+            }
+
+            if (m_statsEnabled)
+            {
+                escapedPixels += static_cast<uint64_t>(std::count_if(rowIters, rowIters + tile.width, [this](int n) {
+                    return n < m_maxIterations;
+                }));
+            }
+
+            if (!row)
+            {
+                const auto writeStart = m_statsEnabled ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+                m_outputDevice->write(tile.x, firstRow + y, std::move(rowColors));
+                if (m_statsEnabled)
+                    outputSeconds += secondsSince(writeStart);
+            }
+        }
+
+        if (m_statsEnabled)
+        {
+            WorkerStats *worker = recordTile(TileStats { Tile { tile.x, firstRow + tile.y, tile.width, tile.height }, spacing,
+                                                         RenderPhase::Color, 0, secondsSince(tileStart), 0 });
+
+            // Only the final pass colors every pixel from its own escape time data
+            if (worker && spacing == 1)
+            {
+                worker->escapedPixels += escapedPixels;
+                worker->inSetPixels += static_cast<uint64_t>(tile.width) * tile.height - escapedPixels;
+                worker->supersampledPixels += supersampledPixels;
+            }
+            if (worker)
+                worker->outputSeconds += outputSeconds;
+        }
+    }
+
+    void MandelbrotSet::supersampleTile(const Tile &tile, const Tile &region, const std::vector<color_t> &colors, int firstRow,
+                                        EdgeSamples &edgeSamples)
+    {
+        auto differ = [this](int n0, int n1, color_t a, color_t b) {
+            return (m_iterationThreshold >= 0 && std::abs(n0 - n1) > m_iterationThreshold)
+                || (m_colorThreshold >= 0 && (std::abs(a.argb.r - b.argb.r) > m_colorThreshold
+                                              || std::abs(a.argb.g - b.argb.g) > m_colorThreshold
+                                              || std::abs(a.argb.b - b.argb.b) > m_colorThreshold));
+        };
+
+        // Each pair of neighbouring pixels in the region is compared once, marking both pixels as edges if they
+        // differ. Every edge of the tile is found before any of the colors it is found by are replaced.
+        std::vector<char> isEdge(colors.size(), 0);
+        for (int y = 0; y < region.height; ++y)
+        {
+            const int *rowIterations = m_iterationBuffer.getIterations() + m_iterationBuffer.indexOf(region.x, region.y + y);
+            const color_t *rowColors = colors.data() + static_cast<size_t>(y) * region.width;
+            char *rowEdges = isEdge.data() + static_cast<size_t>(y) * region.width;
+            const bool last = y + 1 == region.height;
+            for (int x = 0; x < region.width; ++x)
+            {
+                const int n = rowIterations[x];
+                const color_t c = rowColors[x];
+                auto compare = [&](int dx, int dy) {
+                    const int offset = dy * region.width + dx;
+                    const int offsetIterations = dy * m_iterationBuffer.getWidth() + dx;
+                    if (differ(n, rowIterations[x + offsetIterations], c, rowColors[x + offset]))
+                        rowEdges[x] = rowEdges[x + offset] = 1;
+                };
+
+                if (x + 1 < region.width)
+                    compare(1, 0);
+                if (last)
+                    continue;
+                if (x > 0)
+                    compare(-1, 1);
+                compare(0, 1);
+                if (x + 1 < region.width)
+                    compare(1, 1);
+            }
+        }
+
+        std::vector<std::vector<int>> edges(tile.height);
+        for (int y = tile.y; y < tile.y + tile.height; ++y)
+        {
+            for (int x = tile.x; x < tile.x + tile.width; ++x)
+            {
+                if (isEdge[static_cast<size_t>(y - region.y) * region.width + x - region.x])
+                    edges[y - tile.y].push_back(x);
+            }
+        }
+
+        const double xOffset = (-1.0 * static_cast<double>(m_outputWidth)) / 2.0;
+        const double yOffset = (-1.0 * static_cast<double>(m_outputHeight)) / 2.0 + firstRow;
+        const int extra = m_supersamples - 1;
+
+        edgeSamples.columns.clear();
+        edgeSamples.rows.clear();
+        edgeSamples.iterations.clear();
+        edgeSamples.modZ.clear();
+        edgeSamples.modDz.clear();
+
+        IterationBuffer samples;
+        std::vector<int> indices;
+        for (int y = tile.y; y < tile.y + tile.height && !isCancelled(); ++y)
+        {
+            const std::vector<int> &columns = edges[y - tile.y];
+            if (columns.empty())
+                continue;
+
+            // The samples of the edges along a row are iterated together, as a tile with a column for each
+            // sample. Each pixel is divided into a grid of cells, and takes one sample from every column of
+            // cells, each from a different row of cells, at a random position within the cell. Pixels on the
+            // same row share the rows of cells, which only differ in the order the pixels take them in.
+            const int count = static_cast<int>(columns.size());
+            const uint32_t frameRow = static_cast<uint32_t>(firstRow + y);
+            const Tile sampleTile { 0, 0, count * extra, extra };
+            samples.resize(sampleTile.width, sampleTile.height);
+            TileData data(sampleTile, xOffset, yOffset, samples, m_mpfrWorkspaces.local(), m_renderRun == &MandelbrotSet::renderSectionPrecise);
+            for (int j = 0; j < extra; ++j)
+                data.rows[j] = y - 0.5 + (j + hashToUnit(frameRow, static_cast<uint32_t>(j), 0)) / extra;
+
+            indices.clear();
+            for (int e = 0; e < count; ++e)
+            {
+                const int x = columns[e];
+                const int shift = static_cast<int>(hashToUnit(static_cast<uint32_t>(x), frameRow, 0) * extra);
+                for (int i = 0; i < extra; ++i)
                 {
-                    rowColors.emplace_back(m_colorStrategy->getColorInSet());
+                    data.columns[e * extra + i] = x - 0.5 + (i + hashToUnit(static_cast<uint32_t>(x), frameRow, static_cast<uint32_t>(i + 1))) / extra;
+                    indices.push_back((i + shift) % extra * sampleTile.width + e * extra + i);
                 }
             }
 
-            m_outputDevice->write(0, y, std::move(rowColors));
+            prepareCoordinates(data, m_renderRun);
+            (this->*m_renderRun)(data, indices.data(), static_cast<int>(indices.size()));
+            resolveGlitches(data);
+
+            m_storedIterations += data.storedIterations;
+            m_seriesSkippedIterations += data.seriesSkippedIterations;
+            m_interiorSkippedIterations += data.interiorSkippedIterations;
+
+            // Samples of a cancelled frame may not have been iterated
+            if (isCancelled())
+                break;
+
+            // The samples are kept in the order of the pixels they belong to
+            for (int e = 0; e < count; ++e)
+            {
+                edgeSamples.columns.push_back(columns[e]);
+                edgeSamples.rows.push_back(y);
+            }
+            for (const int index : indices)
+            {
+                const size_t p = samples.indexOf(index % sampleTile.width, index / sampleTile.width);
+                edgeSamples.iterations.push_back(samples.getIterations()[p]);
+                edgeSamples.modZ.push_back(samples.getModZ()[p]);
+                edgeSamples.modDz.push_back(samples.getModDz()[p]);
+            }
         }
+    }
+
+    uint64_t MandelbrotSet::blendSamples(const Tile &region, std::vector<color_t> &colors, const EdgeSamples &samples)
+    {
+        const int count = static_cast<int>(samples.columns.size());
+        if (count == 0)
+            return 0;
 
-        mpfr_clears(zI, zI2, zR, zR2, dzI, dzR, dzTmp, cIm, cRe, (mpfr_ptr)0);
+        const int numSamples = static_cast<int>(samples.iterations.size());
+        const int extra = numSamples / count;
+        std::vector<color_t> sampleColors(numSamples);
+        m_colorStrategy->getColors(samples.modZ.data(), samples.modDz.data(), samples.iterations.data(), numSamples,
+                                   m_maxIterations, sampleColors.data());
 
-        m_threadsComplete++;
-        m_cv.notify_one();
+        // Colors are averaged in linear light, so that the edges are neither darkened nor brightened
+        const std::array<float, 256> &linear = getLinearIntensities();
+        for (int e = 0; e < count; ++e)
+        {
+            color_t &pixel = colors[static_cast<size_t>(samples.rows[e] - region.y) * region.width + samples.columns[e] - region.x];
+            float r = linear[pixel.argb.r], g = linear[pixel.argb.g], b = linear[pixel.argb.b];
+            for (int i = e * extra; i < (e + 1) * extra; ++i)
+            {
+                r += linear[sampleColors[i].argb.r];
+                g += linear[sampleColors[i].argb.g];
+                b += linear[sampleColors[i].argb.b];
+            }
+
+            const float weight = 1.0f / static_cast<float>(extra + 1);
+            pixel.argb.r = toColorChannel(r * weight);
+            pixel.argb.g = toColorChannel(g * weight);
+            pixel.argb.b = toColorChannel(b * weight);
+        }
+
+        return static_cast<uint64_t>(count);
+    }
+
+    const IterationBuffer &MandelbrotSet::getIterationBuffer() const noexcept
+    {
+        return m_iterationBuffer;
+    }
+
+    const RenderStats &MandelbrotSet::getRenderStats() const noexcept
+    {
+        return m_stats;
+    }
+
+    void MandelbrotSet::setStatsEnabled(bool enabled)
+    {
+        m_statsEnabled = enabled;
+    }
+
+    void MandelbrotSet::setTileStatsEnabled(bool enabled)
+    {
+        m_tileStatsEnabled = enabled;
+    }
+
+    void MandelbrotSet::beginStats(RenderPath path)
+    {
+        m_stats.path = path;
+        m_stats.precision = Precision::Double;
+        m_stats.mpfrPrecision = 0;
+        m_stats.cancelled = false;
+        m_stats.numThreads = m_threadPool.getThreadCount();
+        m_stats.numBands = 0;
+        m_stats.iterations = 0;
+        m_stats.seriesSkippedIterations = 0;
+        m_stats.interiorSkippedIterations = 0;
+        m_stats.escapedPixels = 0;
+        m_stats.inSetPixels = 0;
+        m_stats.supersampledPixels = 0;
+        m_stats.totalSeconds = 0.0;
+        m_stats.referenceSeconds = 0.0;
+        m_stats.iterateSeconds = 0.0;
+        m_stats.colorSeconds = 0.0;
+        m_stats.histogramSeconds = 0.0;
+        m_stats.outputSeconds = 0.0;
+        m_stats.flushSeconds = 0.0;
+        m_stats.bandSeconds.clear();
+        m_stats.threads.clear();
+        m_stats.tiles.clear();
+
+        if (!m_statsEnabled)
+            return;
+
+        m_workerStats.resize(m_threadPool.getThreadCount());
+        for (WorkerStats &worker : m_workerStats)
+        {
+            worker.totals = ThreadStats { 0, 0, 0.0, 0.0 };
+            worker.escapedPixels = 0;
+            worker.inSetPixels = 0;
+            worker.supersampledPixels = 0;
+            worker.outputSeconds = 0.0;
+            worker.tiles.clear();
+        }
+    }
+
+    void MandelbrotSet::finishStats(std::chrono::steady_clock::time_point frameStart)
+    {
+        m_stats.cancelled = isCancelled();
+        m_stats.totalSeconds = secondsSince(frameStart);
+
+        if (!m_statsEnabled)
+            return;
+
+        // A thread is idle for whatever part of the phases it spends without a tile to work on, which includes
+        // the time it takes to hand out the tiles, and to wait for the slowest of them
+        const double phaseSeconds = m_stats.iterateSeconds + m_stats.colorSeconds;
+        for (const WorkerStats &worker : m_workerStats)
+        {
+            ThreadStats totals = worker.totals;
+            totals.idleSeconds = std::max(0.0, phaseSeconds - totals.busySeconds);
+            m_stats.threads.push_back(totals);
+
+            m_stats.escapedPixels += worker.escapedPixels;
+            m_stats.inSetPixels += worker.inSetPixels;
+            m_stats.supersampledPixels += worker.supersampledPixels;
+            m_stats.outputSeconds += worker.outputSeconds;
+            m_stats.tiles.insert(m_stats.tiles.end(), worker.tiles.begin(), worker.tiles.end());
+        }
+    }
+
+    MandelbrotSet::WorkerStats *MandelbrotSet::recordTile(const TileStats &tileStats)
+    {
+        const int thread = m_threadPool.getCurrentThreadIndex();
+        if (thread < 0)
+            return nullptr;
+
+        WorkerStats &worker = m_workerStats[thread];
+        worker.totals.iterations += tileStats.iterations;
+        worker.totals.busySeconds += tileStats.seconds;
+        ++worker.totals.tiles;
+        if (m_tileStatsEnabled)
+        {
+            worker.tiles.push_back(tileStats);
+            worker.tiles.back().thread = thread;
+        }
+        return &worker;
+    }
+
+    uint64_t MandelbrotSet::getSeriesSkippedIterations() const noexcept
+    {
+        return m_seriesSkippedIterations.load();
+    }
+
+    uint64_t MandelbrotSet::getInteriorSkippedIterations() const noexcept
+    {
+        return m_interiorSkippedIterations.load();
+    }
+
+    void MandelbrotSet::setSeriesApproximationEnabled(bool enabled)
+    {
+        if (enabled != m_seriesApproximationEnabled)
+            invalidateIterationBuffer();
+
+        m_seriesApproximationEnabled = enabled;
     }
 
-    void MandelbrotSet::setCenter(double x, double y)
+    void MandelbrotSet::setCenter(const PreciseReal &x, const PreciseReal &y)
     {
-        m_centerX = x;
-        m_centerY = y;
+        if (x != m_preciseCenterX || y != m_preciseCenterY)
+            invalidateIterationBuffer();
+
+        m_preciseCenterX = x;
+        m_preciseCenterY = y;
+        roundCenter();
     }
 
     void MandelbrotSet::setColorStrategy(std::unique_ptr<ColorStrategy> colorStrategy)
     {
         m_colorStrategy = std::move(colorStrategy);
+
+        // The histogram of the last frame has yet to be handed to the new strategy
+        m_histogramValid = false;
+    }
+
+    void MandelbrotSet::setDeepZoomMode(DeepZoomMode mode)
+    {
+        if (mode != m_deepZoomMode)
+            invalidateIterationBuffer();
+
+        m_deepZoomMode = mode;
+    }
+
+    void MandelbrotSet::setMinimumPrecision(Precision precision)
+    {
+        if (precision != m_minimumPrecision)
+            invalidateIterationBuffer();
+
+        m_minimumPrecision = precision;
+    }
+
+    void MandelbrotSet::setRenderStrategy(RenderStrategy strategy)
+    {
+        if (strategy != m_renderStrategy)
+            invalidateIterationBuffer();
+
+        m_renderStrategy = strategy;
     }
 
     void MandelbrotSet::setMaxIterations(int maxIterations)
     {
+        if (maxIterations != m_maxIterations)
+            invalidateIterationBuffer();
+
         m_maxIterations = maxIterations;
     }
 
+    void MandelbrotSet::roundCenter()
+    {
+        m_centerX = m_preciseCenterX.toDouble();
+        m_centerY = m_preciseCenterY.toDouble();
+        m_centerRemainderX = m_preciseCenterX.getRemainder();
+        m_centerRemainderY = m_preciseCenterY.getRemainder();
+    }
+
+    void MandelbrotSet::invalidateIterationBuffer()
+    {
+        m_iterationBufferValid = false;
+        m_histogramValid = false;
+        m_retainedRegion = Tile { 0, 0, 0, 0 };
+    }
+
     OutputDevice *MandelbrotSet::getOutputDevice() const noexcept
     {
         return m_outputDevice.get();
@@ -288,6 +1667,9 @@ namespace mandelbrot
 
     void MandelbrotSet::setOutputDimensions(int width, int height)
     {
+        if (width != m_outputWidth || height != m_outputHeight)
+            invalidateIterationBuffer();
+
         m_outputWidth = width;
         m_outputHeight = height;
 
@@ -295,9 +1677,54 @@ namespace mandelbrot
             m_outputDevice->setDimensions(int32_t{width}, int32_t{height});
     }
 
-    void MandelbrotSet::setScale(double scale)
+    void MandelbrotSet::setScale(const FloatExp &scale)
+    {
+        if (scale != m_preciseScale)
+            invalidateIterationBuffer();
+
+        m_preciseScale = scale;
+        m_scale = scale.toDouble();
+    }
+
+    void MandelbrotSet::setTileSize(int tileSize)
+    {
+        if (tileSize <= 0)
+            return;
+
+        // The samples of the edges of the last frame are kept for each of its tiles
+        if (tileSize != m_tileSize && m_supersamples > 1)
+            invalidateIterationBuffer();
+
+        m_tileSize = tileSize;
+    }
+
+    void MandelbrotSet::setBandHeight(int bandHeight)
+    {
+        if (bandHeight >= 0)
+            m_bandHeight = bandHeight;
+    }
+
+    void MandelbrotSet::setSupersampling(int samples, int colorThreshold, int iterationThreshold)
+    {
+        if (samples < 1)
+            return;
+
+        samples = std::min(samples, MaxSupersamples);
+        colorThreshold = std::max(colorThreshold, -1);
+        iterationThreshold = std::max(iterationThreshold, -1);
+
+        // The edges of the last frame were found, and sampled, with the previous settings
+        if (samples != m_supersamples || (samples > 1 && (colorThreshold != m_colorThreshold || iterationThreshold != m_iterationThreshold)))
+            invalidateIterationBuffer();
+
+        m_supersamples = samples;
+        m_colorThreshold = colorThreshold;
+        m_iterationThreshold = iterationThreshold;
+    }
+
+    int MandelbrotSet::getThreadCount() const noexcept
     {
-        m_scale = scale;
+        return m_threadPool.getThreadCount();
     }
 }
 
@@ -2,37 +2,306 @@
 #define _MANDELBROT_LIB_MANDELBROT_H_
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include "color/color.h"
 #include "color/color-strategy.h"
+#include "iteration-buffer.h"
+#include "iteration-histogram.h"
+#include "kernel/escape-time-kernel.h"
+#include "kernel/float-exp.h"
+#include "kernel/mpfr-workspace.h"
+#include "kernel/precise-real.h"
+#include "kernel/precision.h"
+#include "kernel/reference-orbit.h"
+#include "kernel/series-approximation.h"
 #include "output/output-device.h"
+#include "threading/cancellation-token.h"
 #include "threading/thread-pool.h"
 
 namespace mandelbrot
 {
 
+/// Methods of calculating the set once the scale is too small for double precision coordinates
+enum class DeepZoomMode
+{
+    /// Iterates each pixel in double precision, as an offset from a high precision reference orbit
+    Perturbation,
+
+    /// Iterates each pixel directly, in double-double precision while it suffices, and with MPFR beyond.
+    /// Much slower, but useful as a point of comparison
+    Precise
+};
+
+/// Strategies for deciding which pixels of a tile are iterated
+enum class RenderStrategy
+{
+    /// Every pixel is iterated
+    Exhaustive,
+
+    /// Mariani-Silver subdivision: the border of a rectangle is iterated first. When every pixel on the
+    /// border has the same iteration count, the inside is filled in without being iterated. Otherwise
+    /// the rectangle is split in two, and the process is repeated for each half. Regions inside the set
+    /// are reproduced exactly, while smooth coloring inside a filled band is interpolated along each row.
+    MarianiSilver
+};
+
+/// Rectangular region of the output device, in pixels
+struct Tile
+{
+    int x;
+    int y;
+    int width;
+    int height;
+};
+
+/// Methods of calculating the escape time data of a frame
+enum class RenderPath
+{
+    /// Iterates each pixel in double precision
+    Direct,
+
+    /// Iterates each pixel relative to a reference orbit, see \ref DeepZoomMode::Perturbation
+    Perturbation,
+
+    /// Iterates each pixel directly in double-double precision or with MPFR, see \ref DeepZoomMode::Precise
+    Precise
+};
+
+/// Phases of a frame in which its tiles are handed to the worker threads
+enum class RenderPhase
+{
+    /// Calculating the escape time data of the tile
+    Iterate,
+
+    /// Coloring the tile, and writing it to the output device
+    Color
+};
+
+/// Work done on a single tile of a frame
+struct TileStats
+{
+    /// Region of the frame covered by the tile
+    Tile tile;
+
+    /// Grid spacing of the pass the tile belongs to, see \ref MandelbrotSet::renderProgressive()
+    int spacing;
+
+    RenderPhase phase;
+
+    /// Index of the worker thread that processed the tile
+    int thread;
+
+    double seconds;
+
+    /// Iterations performed for the tile. Only counted in the \ref RenderPhase::Iterate phase
+    uint64_t iterations;
+};
+
+/// Work done by a single worker thread during a frame
+struct ThreadStats
+{
+    /// Iterations performed by the thread
+    uint64_t iterations;
+
+    /// Number of tiles processed by the thread, in either phase
+    int tiles;
+
+    /// Time spent processing tiles
+    double busySeconds;
+
+    /// Time spent waiting for work during the iterate and color phases, while other threads were still busy
+    double idleSeconds;
+};
+
+/**
+ * @struct RenderStats
+ * @brief Instrumentation of the last frame rendered or colored by a \ref MandelbrotSet. Times are wall-clock
+ *        times in seconds, summed over the bands and passes of the frame. The per-thread, per-tile and
+ *        per-band data, and the pixel counts, are only collected while enabled by
+ *        \ref MandelbrotSet::setStatsEnabled(), and the per-tile and per-band data can be left out of those
+ *        by \ref MandelbrotSet::setTileStatsEnabled(); the rest is always collected.
+ */
+struct RenderStats
+{
+    /// Method used to calculate the escape time data of the frame
+    RenderPath path;
+
+    /// Arithmetic the pixels were iterated in. Perturbations are always iterated in double precision
+    Precision precision;
+
+    /// Bits of precision of the MPFR numbers used for the pixels or the reference orbits, or 0 if none were used
+    int mpfrPrecision;
+
+    /// Set if the frame was cancelled before it was complete
+    bool cancelled;
+
+    int numThreads;
+
+    /// Number of bands the frame was rendered in, see \ref MandelbrotSet::setBandHeight()
+    int numBands;
+
+    /// Iterations actually performed, leaving out those skipped by the series approximation or by the
+    /// interior checks. Pixels filled in by the Mariani-Silver algorithm take no iterations, while the samples
+    /// taken by supersampling are counted along with the pixels
+    uint64_t iterations;
+
+    /// See \ref MandelbrotSet::getSeriesSkippedIterations()
+    uint64_t seriesSkippedIterations;
+
+    /// See \ref MandelbrotSet::getInteriorSkippedIterations()
+    uint64_t interiorSkippedIterations;
+
+    /// Pixels of the final pass that escaped, and that were taken to be part of the set
+    uint64_t escapedPixels;
+    uint64_t inSetPixels;
+
+    /// Pixels of the final pass along edges, which were given the average color of several samples.
+    /// See \ref MandelbrotSet::setSupersampling()
+    uint64_t supersampledPixels;
+
+    /// Time taken by the frame as a whole
+    double totalSeconds;
+
+    /// Time spent calculating the reference orbit and series approximation of deep zoom frames
+    double referenceSeconds;
+
+    /// Time spent calculating the escape time data of the tiles
+    double iterateSeconds;
+
+    /// Time spent coloring the tiles and writing them to the output device
+    double colorSeconds;
+
+    /// Time spent summing the iteration histograms of the worker threads for histogram coloring, along with
+    /// counting the pixels of a frame that was rendered without them. Counting is otherwise part of iterating
+    double histogramSeconds;
+
+    /// Time spent in the output device while preparing its rows, and receiving rows it cannot be written into
+    /// directly. The latter is part of the color phase, and summed over the worker threads
+    double outputSeconds;
+
+    /// Time spent flushing the output device
+    double flushSeconds;
+
+    /// Time taken by each band of the frame
+    std::vector<double> bandSeconds;
+
+    /// Work done by each worker thread
+    std::vector<ThreadStats> threads;
+
+    /// Work done on each tile, in either phase and every pass, grouped by the thread that did it
+    std::vector<TileStats> tiles;
+};
+
 class MandelbrotSet
 {
 public:
-    explicit MandelbrotSet();
+    /// Constructs the set with the given number of worker threads. If numThreads is not positive,
+    /// one worker thread is created per hardware thread of the processor
+    explicit MandelbrotSet(int numThreads = 0);
     ~MandelbrotSet();
 
     /**
      * @brief Calculates the Mandelbrot set at current scale and offset, feeding
      *        the output into the current output device. If the color strategy or
      *        output device are invalid, no calculations will be made.
+     * @param cancellationToken Optional token, checked by the worker threads for every row of
+     *        pixels. Once it is cancelled, the frame is abandoned and nothing is written to the output device
+     */
+    void render(const CancellationToken *cancellationToken = nullptr);
+
+    /**
+     * @brief Calculates the Mandelbrot set as \ref render() does, in passes of increasing resolution.
+     *        The first pass calculates every 8th pixel along each axis, the second pass every 4th
+     *        pixel, and the final pass the remaining pixels. Pixels calculated by a pass are not
+     *        calculated again by the passes after it. After each pass, the whole frame is written
+     *        to the output device with the missing pixels filled in, and the device is flushed.
+     * @param onPassComplete Invoked after each pass, once the output device has been flushed. Frames rendered
+     *        in bands (see \ref setBandHeight()) invoke it after each pass of every band
+     * @param cancellationToken Optional token, as for \ref render(). Passes after the cancellation are skipped
+     */
+    void renderProgressive(const std::function<void()> &onPassComplete, const CancellationToken *cancellationToken = nullptr);
+
+    /**
+     * @brief Colors the escape time data of the last frame again with the current color strategy,
+     *        feeding the output into the current output device. No pixel is iterated, unless the
+     *        parameters of the set have changed since the last frame, in which case it is rendered
+     *        in full as by \ref render(). The samples taken along the edges of the last frame are
+     *        colored again as well, see \ref setSupersampling().
+     * @param cancellationToken Optional token, as for \ref render()
+     */
+    void recolor(const CancellationToken *cancellationToken = nullptr);
+
+    /**
+     * @brief Moves the center of the set by the given number of pixels along each axis. The escape
+     *        time data of the pixels that remain in view is kept, so that the next frame only
+     *        calculates the pixels that have come into view, as long as no other parameters of the
+     *        set are changed in the meantime.
+     * @param dx Number of pixels to move the center by along the real axis
+     * @param dy Number of pixels to move the center by along the imaginary axis
      */
-    void render();
+    void scroll(int dx, int dy);
 
     /**
-     * @brief Sets the center coordinates on the Mandelbrot plane (not the output device)
+     * @brief Returns the escape time data of the last frame, or of its last band if it was rendered in
+     *        bands. Only complete once a frame has been rendered without being cancelled.
+     */
+    const IterationBuffer &getIterationBuffer() const noexcept;
+
+    /**
+     * @brief Returns the number of iterations that were skipped by the series approximation in the
+     *        last frame, summed over every pixel. Only deep zoom frames rendered with
+     *        \ref DeepZoomMode::Perturbation make use of the series approximation.
+     */
+    uint64_t getSeriesSkippedIterations() const noexcept;
+
+    /**
+     * @brief Returns the number of iterations that were saved in the last frame by recognizing points
+     *        within the set early: points inside the main cardioid or the period-2 bulb are not iterated
+     *        at all, and the orbits of other points stop once they are found to be periodic. Summed over
+     *        every pixel. Frames rendered with \ref DeepZoomMode::Perturbation make use of neither.
+     */
+    uint64_t getInteriorSkippedIterations() const noexcept;
+
+    /// Returns the instrumentation of the last call to \ref render(), \ref renderProgressive() or \ref recolor()
+    const RenderStats &getRenderStats() const noexcept;
+
+    /**
+     * @brief Enables or disables collecting the per-thread, per-tile and per-band data of \ref RenderStats,
+     *        and its pixel counts. Disabled by default, as the worker threads time every tile they process
+     *        while it is enabled.
+     */
+    void setStatsEnabled(bool enabled);
+
+    /**
+     * @brief Enables or disables recording the time taken by each tile and band in \ref RenderStats, while
+     *        \ref setStatsEnabled() is set. The per-thread totals and pixel counts are collected either way.
+     *        Enabled by default. Disabling it spares a frame the growing list of tiles when only its totals
+     *        are shown.
+     */
+    void setTileStatsEnabled(bool enabled);
+
+    /**
+     * @brief Enables or disables skipping the first iterations of deep zoom frames with
+     *        a series approximation of the reference orbit. Enabled by default. Frames deeper than
+     *        about 1e-280 are iterated in full, as the offsets of their pixels are beyond the range of a double.
+     */
+    void setSeriesApproximationEnabled(bool enabled);
+
+    /**
+     * @brief Sets the center coordinates on the Mandelbrot plane (not the output device). Every bit of the
+     *        coordinates is kept, so that deep zoom frames are centered exactly where they were asked to be.
      * @param x Center position on the real portion of the plane (horizontal)
      * @param y Center position on the imaginary portion of the plane (vertical)
      */
-    void setCenter(double x, double y);
+    void setCenter(const PreciseReal &x, const PreciseReal &y);
 
     /**
      * @brief Sets the coloring method to render items in and out of the mandelbrot
@@ -41,6 +310,28 @@ public:
      */
     void setColorStrategy(std::unique_ptr<ColorStrategy> colorStrategy);
 
+    /**
+     * @brief Sets the method used to calculate the set at deep zoom levels
+     * @param mode Deep zoom method. Defaults to \ref DeepZoomMode::Perturbation
+     */
+    void setDeepZoomMode(DeepZoomMode mode);
+
+    /**
+     * @brief Sets the least precise arithmetic frames are iterated in. Each frame is iterated in the fastest
+     *        arithmetic, no less precise than this, that is precise enough for its scale, up to MPFR for the
+     *        deepest. Frames beyond the reach of double precision are deep zoom frames, see \ref setDeepZoomMode().
+     *        Single precision is opt-in: it is faster for shallow frames, but its rounding can show in their
+     *        smooth coloring.
+     * @param precision Least precise arithmetic. Defaults to \ref Precision::Double
+     */
+    void setMinimumPrecision(Precision precision);
+
+    /**
+     * @brief Sets the strategy deciding which pixels are iterated, and which may be filled in
+     * @param strategy Render strategy. Defaults to \ref RenderStrategy::Exhaustive
+     */
+    void setRenderStrategy(RenderStrategy strategy);
+
     /**
      * @brief Sets the maximum number of times to iterate the Mandelbrot function z -> z^2 + c
      *        before assuming any given point does indeed belong to the set.
@@ -70,17 +361,187 @@ public:
     /**
      * @brief Sets the scale, or "zoom" factor in which the points in the Mandelbrot set
      *        will be calculated
-     * @param Scale factor. This should be a very small fractional value for good results.
+     * @param Scale factor. This should be a very small fractional value for good results. Frames at any depth,
+     *        including those smaller than the range of a double, are rendered by perturbation, with the offsets
+     *        from the reference orbit rescaled to stay within that range. MPFR is only used to iterate pixels
+     *        when \ref DeepZoomMode::Precise is selected
+     */
+    void setScale(const FloatExp &scale);
+
+    /**
+     * @brief Sets the size of the square tiles that each frame is split into. Each tile is
+     *        a separate task for the worker threads.
+     * @param tileSize Width and height of a tile, in pixels. Defaults to 64
+     */
+    void setTileSize(int tileSize);
+
+    /**
+     * @brief Sets the number of rows of the frame that are rendered at a time. Frames taller than this
+     *        are rendered in bands, top to bottom, holding the escape time data of a single band in
+     *        memory. Each band is written to the output device and flushed before the next one is
+     *        started, which lets devices such as \ref OutputDeviceBMP stream frames larger than memory.
+     *        The escape time data of a banded frame is not kept for \ref recolor() or \ref scroll().
+     *        Frames colored by a strategy that uses the histogram of the whole frame are never banded, and neither
+     *        are frames supersampled along their edges, see \ref setSupersampling().
+     * @param bandHeight Rows per band, preferably a multiple of the tile size. Defaults to 0, which renders
+     *        every frame in one go
+     */
+    void setBandHeight(int bandHeight);
+
+    /**
+     * @brief Sets up adaptive supersampling of the edges of the frame. Each pixel is first rendered from a single
+     *        sample at its center. Pixels whose color, or iteration count, differs from that of one of their eight
+     *        neighbours by more than a threshold are then sampled again at jittered positions spread over their
+     *        area, and given the average color of their samples, averaged in linear light. Pixels in smooth areas
+     *        take no samples beyond the first. Edges are looked for in the final pass of a frame, and their samples
+     *        are kept along with its escape time data, so that \ref recolor() averages the new colors of the same
+     *        samples without iterating any of them.
+     * @param samples Samples taken of each pixel along an edge, including the first one, up to 64. Defaults to 1,
+     *        which turns supersampling off
+     * @param colorThreshold Largest difference in any color channel, from 0 to 255, between neighbouring pixels
+     *        that does not make an edge, or -1 to leave colors out
+     * @param iterationThreshold Largest difference in iteration count between neighbouring pixels that does not
+     *        make an edge, or -1 to leave iteration counts out. Pixels within the set count as maxIterations
      */
-    void setScale(double scale);
+    void setSupersampling(int samples, int colorThreshold = 16, int iterationThreshold = -1);
+
+    /// Returns the number of worker threads used to render the set
+    int getThreadCount() const noexcept;
 
 private:
-    /// Renders a portion of the mandelbrot set, from startRow to startRow + numRows
-    void renderSection(int startRow, int numRows, const double xOffset, const double yOffset);
+    /// Escape time data of a tile that is being rendered
+    struct TileData;
+
+    /// Statistics gathered by a single worker thread during a frame
+    struct WorkerStats;
+
+    /// Calculates the escape time data of a batch of pixels of a tile, given by their indices within the tile
+    typedef void (MandelbrotSet::*RunPtr)(TileData &, const int *, int);
+
+    /// Pixels of the frame calculated by a render pass
+    struct Pass
+    {
+        /// Only the pixels on the grid with this spacing are calculated
+        int spacing;
+
+        /// Spacing of the grid calculated by the previous pass, or 0 for the first pass
+        int previousSpacing;
+
+        /// Region of the frame whose pixels were kept from the previous frame by \ref scroll()
+        Tile retained;
+    };
+
+    /// Samples taken by supersampling the edges of a tile, kept so that the frame can be recolored
+    struct EdgeSamples
+    {
+        /// Position of each pixel along an edge, within \ref m_iterationBuffer
+        std::vector<int> columns;
+        std::vector<int> rows;
 
-    /// Renders a portion of the mandelbrot set, from startRow to startRow + numRows, at deep zoom levels
-    /// using MPFR for precision
-    void renderSectionPrecise(int startRow, int numRows, const double xOffset, const double yOffset);
+        /// Escape time data of the samples, m_supersamples - 1 of them for each pixel in turn
+        std::vector<int> iterations;
+        std::vector<float> modZ;
+        std::vector<float> modDz;
+    };
+
+    /// Runs the given task on the thread pool for each index in [0, numTasks). Returns once every task has been completed
+    void forEachTask(int numTasks, const std::function<void(int)> &task);
+
+    /// Splits the frame into tiles, and runs the given task for each of them on the thread pool. Returns
+    /// once every task has been completed
+    void forEachTile(const std::function<void(const Tile &)> &task);
+
+    /// Counts the pixels of a tile that are on the grid of the given spacing in the iteration histogram of the calling thread
+    void countHistogram(const Tile &tile, int spacing);
+
+    /// Sums the iteration histograms of the worker threads in parallel, and hands the result to the color strategy
+    void mergeHistogram();
+
+    /// Renders the frame in passes, each calculating the pixels on a grid with the given spacing
+    void renderPasses(std::initializer_list<int> spacings, const std::function<void()> &onPassComplete,
+                      const CancellationToken *cancellationToken);
+
+    /// Calculates the escape time data of the pixels of a tile belonging to the given pass, using the given render path.
+    /// The first row of the buffer is the given row of the frame
+    void renderTile(const Tile &tile, const double xOffset, const double yOffset, RunPtr renderRun, const Pass &pass, int firstRow);
+
+    /// Sets up the points of the tile to be iterated along the given render path, from the positions of its columns and rows
+    void prepareCoordinates(TileData &data, RunPtr renderRun);
+
+    /// Stores the escape time data of the pixel at the given index within the tile in the output buffer of the tile
+    void storePixel(TileData &data, int idx, double zRe, double zIm, double dzRe, double dzIm, int iterations);
+
+    /// Calculates a batch of pixels of a tile in the given precision, which is either \ref Precision::Float,
+    /// \ref Precision::Double or \ref Precision::DoubleDouble
+    template <Precision P>
+    void renderSection(TileData &data, const int *indices, int count);
+
+    /// Calculates a batch of pixels of a tile at deep zoom levels using MPFR for precision
+    void renderSectionPrecise(TileData &data, const int *indices, int count);
+
+    /// Calculates a batch of pixels of a tile at deep zoom levels using perturbations of the
+    /// reference orbit calculated at the center of the plane
+    void renderSectionPerturbation(TileData &data, const int *indices, int count);
+
+    /// Iterates the pixels flagged as glitched by \ref renderSectionPerturbation against new reference orbits
+    void resolveGlitches(TileData &data);
+
+    /// Calculates the given pixels of a tile, skipping those that have been calculated already
+    void renderPixels(TileData &data, RunPtr renderRun, std::vector<int> &indices);
+
+    /// Mariani-Silver subdivision of the rectangle from (x0, y0) to (x1, y1) inclusive, relative to the tile
+    void subdivide(TileData &data, RunPtr renderRun, int x0, int y0, int x1, int y1);
+
+    /// Returns true if the frame being rendered has been cancelled
+    bool isCancelled() const noexcept;
+
+    /// Signals the thread waiting in \ref forEachTask() that another task has been completed
+    void onTaskComplete();
+
+    /// Colors the escape time data in \ref m_iterationBuffer for the given pass, and flushes the output device.
+    /// The first row of the buffer is written to the given row of the frame. The edges of the final pass are
+    /// sampled if sampleEdges is set, and the samples kept in \ref m_edgeSamples are colored otherwise
+    void colorFrame(const Pass &pass, int firstRow, bool sampleEdges);
+
+    /// Colors the escape time data of a tile, and writes it to the output device. Only the pixels calculated
+    /// by the given pass and the passes before it are expected to be known
+    void colorTile(const Tile &tile, const Pass &pass, int firstRow, bool sampleEdges);
+
+    /**
+     * @brief Finds the pixels of a tile along edges, and iterates several samples of each of them.
+     *        See \ref setSupersampling()
+     * @param tile Tile of \ref m_iterationBuffer, whose first row is the given row of the frame
+     * @param region Colored pixels of the buffer, which cover the tile and its neighbours on every side
+     * @param colors Colors of the pixels of the region, row by row
+     * @param samples Receives the samples of the edges of the tile
+     */
+    void supersampleTile(const Tile &tile, const Tile &region, const std::vector<color_t> &colors, int firstRow,
+                         EdgeSamples &samples);
+
+    /**
+     * @brief Replaces the colors of the pixels along edges with the average color of their samples
+     * @param region Colored pixels of \ref m_iterationBuffer
+     * @param colors Colors of the pixels of the region, row by row
+     * @param samples Samples of the edges within the region
+     * @return Number of pixels supersampled
+     */
+    uint64_t blendSamples(const Tile &region, std::vector<color_t> &colors, const EdgeSamples &samples);
+
+    /// Marks the escape time data of the last frame as unusable, after the parameters of the set have changed
+    void invalidateIterationBuffer();
+
+    /// Updates the doubles approximating the center, after it has changed
+    void roundCenter();
+
+    /// Resets \ref m_stats and the statistics of the worker threads at the start of a frame
+    void beginStats(RenderPath path);
+
+    /// Completes \ref m_stats at the end of a frame started at the given time, from the statistics of the worker threads
+    void finishStats(std::chrono::steady_clock::time_point frameStart);
+
+    /// Adds a processed tile to the statistics of the worker thread calling it, returning them. Returns nullptr if
+    /// called from outside of the thread pool
+    WorkerStats *recordTile(const TileStats &tileStats);
 
 private:
     int m_maxIterations;
@@ -89,23 +550,149 @@ private:
 
     int m_outputHeight;
 
-    double m_centerX;
+    /// Center and scale of the frame, as they were given
+    PreciseReal m_preciseCenterX;
+    PreciseReal m_preciseCenterY;
+    FloatExp m_preciseScale;
 
+    /// Center and scale rounded to doubles, as used by the render paths that do not iterate with MPFR. The
+    /// scale is zero if it is beyond the range of a double
+    double m_centerX;
     double m_centerY;
-
     double m_scale;
 
+    /// Differences between the center and its doubles, which make up the center in double-double precision
+    double m_centerRemainderX;
+    double m_centerRemainderY;
+
     std::unique_ptr<ColorStrategy> m_colorStrategy;
 
     std::unique_ptr<OutputDevice> m_outputDevice;
 
+    /// Width and height of the tiles a frame is split into
+    int m_tileSize;
+
+    /// Number of rows of the frame rendered at a time, or 0 to render the whole frame at once
+    int m_bandHeight;
+
     ThreadPool m_threadPool;
 
     std::mutex m_mutex;
 
     std::condition_variable m_cv;
 
-    std::atomic_int m_threadsComplete;
+    /// Number of tasks posted by \ref forEachTask() that have been completed, guarded by \ref m_mutex
+    int m_tasksComplete;
+
+    /// Vectorized (if supported by the processor) kernels used by \ref renderSection, in double and single precision
+    EscapeTimeKernel m_escapeTimeKernel;
+    EscapeTimeKernel m_floatEscapeTimeKernel;
+
+    /// Least precise arithmetic frames are iterated in
+    Precision m_minimumPrecision;
+
+    /// Bits of precision of the MPFR numbers used by the current frame
+    int m_mpfrPrecision;
+
+    /// Preallocated MPFR registers, one workspace per worker thread followed by one for the thread rendering
+    /// the frame, so that the MPFR calculations of a frame neither allocate nor share any state
+    WorkerLocal<MpfrWorkspace> m_mpfrWorkspaces;
+
+    /// Method of calculating the set at deep zoom levels
+    DeepZoomMode m_deepZoomMode;
+
+    /// Strategy deciding which pixels are iterated
+    RenderStrategy m_renderStrategy;
+
+    /// High precision orbit of the center point, used by \ref renderSectionPerturbation
+    ReferenceOrbit m_referenceOrbit;
+
+    /// Center point and maximum number of iterations \ref m_referenceOrbit was calculated for. No orbit
+    /// has been calculated while the number of iterations is 0
+    PreciseReal m_referenceCenterX;
+    PreciseReal m_referenceCenterY;
+    int m_referenceIterations;
+
+    /// Bits of precision \ref m_referenceOrbit was calculated with
+    int m_referencePrecision;
+
+    /// Set if the offsets of the pixels of the current frame from the reference point are given in pixels rather
+    /// than as coordinates, for perturbation frames too deep for the offsets to be doubles
+    bool m_rescaledOffsets;
+
+    /// Series approximation of the reference orbit, shared by every pixel of the frame
+    SeriesApproximation m_series;
+
+    /// Flag indicating whether or not \ref m_series is used to skip iterations
+    bool m_seriesApproximationEnabled;
+
+    /// Iterations skipped by the series approximation in the current frame
+    std::atomic<uint64_t> m_seriesSkippedIterations;
+
+    /// Iterations saved in the current frame by the cardioid and bulb test, and the periodicity check
+    std::atomic<uint64_t> m_interiorSkippedIterations;
+
+    /// Iteration counts stored for the pixels of the current frame, including the skipped iterations
+    std::atomic<uint64_t> m_storedIterations;
+
+    /// Instrumentation of the last frame
+    RenderStats m_stats;
+
+    /// Flag indicating whether or not the detailed parts of \ref m_stats are collected
+    bool m_statsEnabled;
+
+    /// Flag indicating whether or not the tiles and bands of the frame are recorded along with the detailed parts
+    bool m_tileStatsEnabled;
+
+    /// Each is updated by its own worker without synchronization, so they are kept on separate cache lines
+    struct alignas(64) WorkerStats
+    {
+        ThreadStats totals;
+        uint64_t escapedPixels;
+        uint64_t inSetPixels;
+        uint64_t supersampledPixels;
+        double outputSeconds;
+        std::vector<TileStats> tiles;
+    };
+
+    /// Statistics of each worker thread during the current frame, only gathered while \ref m_statsEnabled is set
+    std::vector<WorkerStats> m_workerStats;
+
+    /// Escape time data of the last frame, or of the band of it being rendered, which the coloring pass works from
+    IterationBuffer m_iterationBuffer;
+
+    /// Flag indicating whether or not \ref m_iterationBuffer holds the frame described by the current parameters
+    bool m_iterationBufferValid;
+
+    /// Distribution of the iteration counts of the pixels of \ref m_iterationBuffer, gathered for color strategies
+    /// that use it. Each worker thread counts the pixels of its tiles, followed by one more histogram for the
+    /// thread rendering the frame
+    IterationHistogram m_histogram;
+
+    /// Set while the current frame gathers \ref m_histogram
+    bool m_histogramEnabled;
+
+    /// Set if \ref m_histogram describes the whole of \ref m_iterationBuffer
+    bool m_histogramValid;
+
+    /// Region of \ref m_iterationBuffer holding valid pixels while the buffer as a whole is not, after \ref scroll()
+    Tile m_retainedRegion;
+
+    /// Samples taken of each pixel along an edge, and the differences between neighbouring pixels that make an
+    /// edge. See \ref setSupersampling()
+    int m_supersamples;
+    int m_colorThreshold;
+    int m_iterationThreshold;
+
+    /// Samples of the edges of each tile of \ref m_iterationBuffer, in the order the tiles are numbered in
+    std::vector<EdgeSamples> m_edgeSamples;
+
+    /// Render path the escape time data in \ref m_iterationBuffer was calculated along, which the samples taken
+    /// by supersampling follow as well. Null until a frame has been rendered
+    RunPtr m_renderRun;
+
+    /// Cancellation token of the frame being rendered, if any
+    const CancellationToken *m_cancellationToken;
 };
 
 }
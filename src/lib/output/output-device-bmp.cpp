@@ -1,15 +1,32 @@
 #include <algorithm>
 #include <cstring>
 #include <fstream>
+#include <limits>
 #include "output-device-bmp.h"
 
 namespace mandelbrot
 {
+    OutputDeviceBMP::OutputDeviceBMP() :
+        m_fileName(),
+        m_data(),
+        m_streaming(false),
+        m_stream(),
+        m_firstRow(0),
+        m_width(0),
+        m_height(0)
+    {
+    }
+
     void OutputDeviceBMP::setFileName(const std::string &fileName)
     {
         m_fileName = fileName;
     }
 
+    void OutputDeviceBMP::setStreaming(bool enabled)
+    {
+        m_streaming = enabled;
+    }
+
     void OutputDeviceBMP::setDimensions(int32_t width, int32_t height)
     {
         if (width <= 0 || height <= 0)
@@ -17,25 +34,72 @@ namespace mandelbrot
 
         m_width = width;
         m_height = height;
+        m_firstRow = 0;
 
         m_data.clear();
-        m_data.resize(height * width);
-        //m_data.reserve(height * width);
+        if (!m_streaming)
+        {
+            m_data.resize(static_cast<size_t>(height) * static_cast<size_t>(width));
+            return;
+        }
+
+        // Rows are written to their place in the file as they are flushed, after the header
+        if (m_stream.is_open())
+            m_stream.close();
+
+        if (m_fileName.empty())
+            return;
+
+        m_stream.open(m_fileName, std::ios_base::binary | std::ios_base::in | std::ios_base::out | std::ios_base::trunc);
+        if (m_stream.is_open())
+            writeHeader(m_stream);
     }
 
     void OutputDeviceBMP::write(int xOffset, int yOffset, std::vector<color_t> &&data)
     {
-        const size_t pos = static_cast<size_t>((yOffset * m_width) + xOffset);
-        const size_t len = pos + data.size() >= m_data.size() ? m_data.size() - pos : data.size();
-        //m_data.insert(m_data.end(), std::make_move_iterator(data.begin()), std::make_move_iterator(data.end()));
+        if (yOffset < m_firstRow || xOffset < 0 || xOffset >= m_width)
+            return;
+
+        const size_t pos = static_cast<size_t>(yOffset - m_firstRow) * m_width + xOffset;
+        if (pos >= m_data.size())
+            return;
+
+        const size_t len = std::min(data.size(), static_cast<size_t>(m_width - xOffset));
         std::copy(data.begin(), data.begin() + len, m_data.begin() + pos);
     }
 
+    void OutputDeviceBMP::beginRows(int y, int height)
+    {
+        if (!m_streaming)
+            return;
+
+        m_firstRow = y;
+        m_data.resize(static_cast<size_t>(std::max(height, 0)) * m_width);
+    }
+
+    color_t *OutputDeviceBMP::getRow(int y)
+    {
+        return m_data.data() + static_cast<size_t>(y - m_firstRow) * m_width;
+    }
+
     void OutputDeviceBMP::flush()
     {
         if (m_fileName.empty() || m_width == 0 || m_height == 0)
             return;
 
+        if (m_streaming)
+        {
+            if (!m_stream.is_open())
+                return;
+
+            // Rows are stored one after the other, so the rows in memory make up a single run of the file
+            const std::streamoff rowSize = static_cast<std::streamoff>(m_width) * BMP_NumChannels;
+            m_stream.seekp(dataOffset() + m_firstRow * rowSize);
+            m_stream.write((const char*)m_data.data(), m_data.size() * BMP_NumChannels);
+            m_stream.flush();
+            return;
+        }
+
         std::ofstream out { m_fileName, std::ios_base::binary };
         if (!out.is_open())
             return;
@@ -44,12 +108,21 @@ namespace mandelbrot
         out.write((const char*)m_data.data(), m_data.size() * BMP_NumChannels);
     }
 
-    void OutputDeviceBMP::writeHeader(std::ofstream &out)
+    std::streamoff OutputDeviceBMP::dataOffset()
     {
+        return sizeof(BitmapFileHeader) + sizeof(BitmapInfoHeader) + sizeof(BitmapColorSpaceHeader);
+    }
+
+    void OutputDeviceBMP::writeHeader(std::ostream &out)
+    {
+        // The size of the file is only recorded up to 4 GB, which readers of larger files have to ignore
+        const uint64_t dataSize = static_cast<uint64_t>(m_width) * static_cast<uint64_t>(m_height) * BMP_NumChannels;
+        const uint64_t fileSize = std::min<uint64_t>(dataOffset() + dataSize, std::numeric_limits<uint32_t>::max());
+
         // Instantiate & build the three header sections of the BMP file
         BitmapFileHeader fileHeader;
-        fileHeader.dataOffset = sizeof(BitmapFileHeader) + sizeof(BitmapInfoHeader) + sizeof(BitmapColorSpaceHeader);
-        fileHeader.fileSize = fileHeader.dataOffset + (m_data.size() * BMP_NumChannels); //(m_height * m_width * BMP_NumChannels);
+        fileHeader.dataOffset = static_cast<uint32_t>(dataOffset());
+        fileHeader.fileSize = static_cast<uint32_t>(fileSize);
 
         BitmapInfoHeader infoHeader;
         infoHeader.infoHeaderSize = sizeof(BitmapInfoHeader) + sizeof(BitmapColorSpaceHeader);
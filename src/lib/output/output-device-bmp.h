@@ -20,8 +20,19 @@ namespace mandelbrot
 class OutputDeviceBMP final : public OutputDevice
 {
 public:
+    OutputDeviceBMP();
+
     void setFileName(const std::string &fileName);
 
+    /**
+     * @brief Enables or disables streaming the file to disk. When enabled, the header is written
+     *        by \ref setDimensions(), and only the rows passed to \ref beginRows() are held in
+     *        memory until \ref flush() writes them to their place in the file. Rows may be written
+     *        in any order. When disabled (the default), the whole image is held in memory and the
+     *        file is written in one go by \ref flush().
+     */
+    void setStreaming(bool enabled);
+
     /**
      * @brief Sets the dimensions of the file
      * @param width Width of the file, in pixels
@@ -33,14 +44,33 @@ public:
 
     void flush() override;
 
+    /// Selects the rows held in memory when streaming, and does nothing otherwise
+    void beginRows(int y, int height) override;
+
+    /// Returns the first pixel of a row of the file, which is written out by \ref flush()
+    color_t *getRow(int y) override;
+
 private:
-    void writeHeader(std::ofstream &out);
+    void writeHeader(std::ostream &out);
+
+    /// Returns the offset of the pixel data within the file
+    static std::streamoff dataOffset();
 
 private:
     std::string m_fileName;
 
+    /// Pixels of the rows held in memory, starting at row \ref m_firstRow
     std::vector<color_t> m_data;
 
+    /// Flag indicating whether or not the file is streamed to disk
+    bool m_streaming;
+
+    /// File being streamed to, opened by \ref setDimensions()
+    std::fstream m_stream;
+
+    /// Row of the image held first in \ref m_data
+    int32_t m_firstRow;
+
     int32_t m_width;
     int32_t m_height;
 };
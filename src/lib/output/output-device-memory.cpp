@@ -0,0 +1,45 @@
+#include <algorithm>
+#include "output-device-memory.h"
+
+namespace mandelbrot
+{
+    OutputDeviceMemory::OutputDeviceMemory() :
+        m_width(0),
+        m_height(0),
+        m_data()
+    {
+    }
+
+    void OutputDeviceMemory::setDimensions(int32_t width, int32_t height)
+    {
+        if (width <= 0 || height <= 0)
+            return;
+
+        m_width = width;
+        m_height = height;
+        m_data.resize(static_cast<size_t>(height) * static_cast<size_t>(width));
+    }
+
+    void OutputDeviceMemory::write(int xOffset, int yOffset, std::vector<color_t> &&data)
+    {
+        if (yOffset < 0 || yOffset >= m_height || xOffset < 0 || xOffset >= m_width)
+            return;
+
+        const size_t len = std::min(data.size(), static_cast<size_t>(m_width - xOffset));
+        std::copy(data.begin(), data.begin() + len, getRow(yOffset) + xOffset);
+    }
+
+    void OutputDeviceMemory::flush()
+    {
+    }
+
+    color_t *OutputDeviceMemory::getRow(int y)
+    {
+        return m_data.data() + static_cast<size_t>(y) * m_width;
+    }
+
+    const std::vector<color_t> &OutputDeviceMemory::getPixels() const noexcept
+    {
+        return m_data;
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef _MANDELBROT_LIB_OUTPUT_DEVICE_MEMORY_H_
+#define _MANDELBROT_LIB_OUTPUT_DEVICE_MEMORY_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "color/color.h"
+#include "output/output-device.h"
+
+namespace mandelbrot
+{
+
+/**
+ * @class OutputDeviceMemory
+ * @brief Holds the output of a mandelbrot set calculation in memory, for the caller to read back
+ *        once the frame has been rendered.
+ */
+class OutputDeviceMemory final : public OutputDevice
+{
+public:
+    OutputDeviceMemory();
+
+    void setDimensions(int32_t width, int32_t height) override;
+
+    void write(int xOffset, int yOffset, std::vector<color_t> &&data) override;
+
+    void flush() override;
+
+    /// Returns the first pixel of a row of the frame
+    color_t *getRow(int y) override;
+
+    /// Returns the pixels of the frame, row by row
+    const std::vector<color_t> &getPixels() const noexcept;
+
+private:
+    int32_t m_width;
+    int32_t m_height;
+
+    std::vector<color_t> m_data;
+};
+
+}
+
+#endif // _MANDELBROT_LIB_OUTPUT_DEVICE_MEMORY_H_
@@ -0,0 +1,33 @@
+#include <cstddef>
+#include "output-device-null.h"
+
+namespace mandelbrot
+{
+    OutputDeviceNull::OutputDeviceNull() :
+        m_width(0),
+        m_data()
+    {
+    }
+
+    void OutputDeviceNull::setDimensions(int32_t width, int32_t height)
+    {
+        if (width <= 0 || height <= 0)
+            return;
+
+        m_width = width;
+        m_data.resize(static_cast<size_t>(height) * static_cast<size_t>(width));
+    }
+
+    void OutputDeviceNull::write(int /*xOffset*/, int /*yOffset*/, std::vector<color_t> &&/*data*/)
+    {
+    }
+
+    void OutputDeviceNull::flush()
+    {
+    }
+
+    color_t *OutputDeviceNull::getRow(int y)
+    {
+        return m_data.data() + static_cast<size_t>(y) * m_width;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef _MANDELBROT_LIB_OUTPUT_DEVICE_NULL_H_
+#define _MANDELBROT_LIB_OUTPUT_DEVICE_NULL_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "color/color.h"
+#include "output/output-device.h"
+
+namespace mandelbrot
+{
+
+/**
+ * @class OutputDeviceNull
+ * @brief Discards the output of a mandelbrot set calculation. Rows are still handed out to be
+ *        written in place, so that coloring a frame costs as much as it does with a device that
+ *        keeps it, while flushing costs nothing. Used to measure the performance of rendering.
+ */
+class OutputDeviceNull final : public OutputDevice
+{
+public:
+    OutputDeviceNull();
+
+    void setDimensions(int32_t width, int32_t height) override;
+
+    void write(int xOffset, int yOffset, std::vector<color_t> &&data) override;
+
+    void flush() override;
+
+    color_t *getRow(int y) override;
+
+private:
+    int32_t m_width;
+
+    /// Scratch space for the rows of a frame, which are never read
+    std::vector<color_t> m_data;
+};
+
+}
+
+#endif // _MANDELBROT_LIB_OUTPUT_DEVICE_NULL_H_
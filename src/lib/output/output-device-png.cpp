@@ -0,0 +1,405 @@
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <zlib.h>
+#include "output-device-png.h"
+
+namespace mandelbrot
+{
+    /// Uncompressed size a chunk of rows aims for. Smaller chunks spread the work more evenly over
+    /// the encoding threads, at the cost of a slightly larger file
+    static constexpr size_t PNG_ChunkSize = 256 * 1024;
+
+    /// Pixels are stored as 8-bit RGB. Every color strategy produces opaque colors, so alpha is left out
+    static constexpr size_t PNG_BytesPerPixel = 3;
+
+    /// Filter types applied to each row before it is deflated
+    enum PngFilter : unsigned char
+    {
+        PNG_FilterNone = 0,
+        PNG_FilterSub,
+        PNG_FilterUp,
+        PNG_FilterAverage,
+        PNG_FilterPaeth,
+        PNG_NumFilters
+    };
+
+    struct OutputDevicePNG::Chunk
+    {
+        /// Rows flushed together, which the rows of this chunk are part of
+        std::shared_ptr<const std::vector<color_t>> band;
+
+        /// Index of the first pixel of the chunk within the band
+        size_t offset;
+
+        int numRows;
+
+        /// Row above the first row of the chunk, or empty for the first row of the image
+        std::vector<color_t> previousRow;
+
+        /// Flag indicating whether or not the chunk begins the zlib stream of the image
+        bool first;
+
+        /// Flag indicating whether or not the chunk ends the zlib stream of the image
+        bool last;
+
+        /// Deflated rows, preceded by the zlib header for the first chunk
+        std::vector<unsigned char> data;
+
+        /// Checksum and size of the filtered rows, before they were deflated
+        unsigned long adler;
+        size_t length;
+
+        /// Set once the chunk has been encoded, guarded by \ref OutputDevicePNG::m_mutex
+        bool done;
+    };
+
+    static void storeBigEndian(uint32_t value, unsigned char *out)
+    {
+        out[0] = static_cast<unsigned char>(value >> 24);
+        out[1] = static_cast<unsigned char>(value >> 16);
+        out[2] = static_cast<unsigned char>(value >> 8);
+        out[3] = static_cast<unsigned char>(value);
+    }
+
+    static void toRGB(const color_t *pixels, int width, unsigned char *out)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            *out++ = pixels[x].argb.r;
+            *out++ = pixels[x].argb.g;
+            *out++ = pixels[x].argb.b;
+        }
+    }
+
+    static unsigned char paethPredictor(int a, int b, int c)
+    {
+        const int p = a + b - c;
+        const int pa = std::abs(p - a);
+        const int pb = std::abs(p - b);
+        const int pc = std::abs(p - c);
+        if (pa <= pb && pa <= pc)
+            return static_cast<unsigned char>(a);
+        return static_cast<unsigned char>(pb <= pc ? b : c);
+    }
+
+    /// Applies a filter to a row of the given length, writing the filtered bytes to out
+    static void applyFilter(PngFilter filter, const unsigned char *prev, const unsigned char *cur, size_t length, unsigned char *out)
+    {
+        for (size_t i = 0; i < length; ++i)
+        {
+            const int a = i >= PNG_BytesPerPixel ? cur[i - PNG_BytesPerPixel] : 0;
+            const int b = prev[i];
+            const int c = i >= PNG_BytesPerPixel ? prev[i - PNG_BytesPerPixel] : 0;
+
+            int predictor = 0;
+            switch (filter)
+            {
+            case PNG_FilterSub: predictor = a; break;
+            case PNG_FilterUp: predictor = b; break;
+            case PNG_FilterAverage: predictor = (a + b) / 2; break;
+            case PNG_FilterPaeth: predictor = paethPredictor(a, b, c); break;
+            default: break;
+            }
+            out[i] = static_cast<unsigned char>(cur[i] - predictor);
+        }
+    }
+
+    OutputDevicePNG::OutputDevicePNG(int numThreads) :
+        m_fileName(),
+        m_fastCompression(false),
+        m_width(0),
+        m_height(0),
+        m_data(),
+        m_firstRow(0),
+        m_nextRow(0),
+        m_previousRow(),
+        m_out(),
+        m_adler(0),
+        m_mutex(),
+        m_cv(),
+        m_chunks(),
+        m_threadPool(numThreads)
+    {
+    }
+
+    OutputDevicePNG::~OutputDevicePNG()
+    {
+        discardChunks();
+    }
+
+    void OutputDevicePNG::setFileName(const std::string &fileName)
+    {
+        m_fileName = fileName;
+    }
+
+    void OutputDevicePNG::setFastCompression(bool enabled)
+    {
+        m_fastCompression = enabled;
+    }
+
+    void OutputDevicePNG::setDimensions(int32_t width, int32_t height)
+    {
+        if (width <= 0 || height <= 0)
+            return;
+
+        discardChunks();
+        if (m_out.is_open())
+            m_out.close();
+
+        m_width = width;
+        m_height = height;
+        m_firstRow = 0;
+        m_nextRow = 0;
+
+        // Rows are only held in memory from beginRows() onwards
+        m_data.clear();
+    }
+
+    void OutputDevicePNG::write(int xOffset, int yOffset, std::vector<color_t> &&data)
+    {
+        if (yOffset < m_firstRow || xOffset < 0 || xOffset >= m_width)
+            return;
+
+        const size_t pos = static_cast<size_t>(yOffset - m_firstRow) * m_width + xOffset;
+        if (pos >= m_data.size())
+            return;
+
+        const size_t len = std::min(data.size(), static_cast<size_t>(m_width - xOffset));
+        std::copy(data.begin(), data.begin() + len, m_data.begin() + pos);
+    }
+
+    void OutputDevicePNG::beginRows(int y, int height)
+    {
+        m_firstRow = y;
+        m_data.resize(static_cast<size_t>(std::max(height, 0)) * m_width);
+    }
+
+    color_t *OutputDevicePNG::getRow(int y)
+    {
+        return m_data.data() + static_cast<size_t>(y - m_firstRow) * m_width;
+    }
+
+    void OutputDevicePNG::flush()
+    {
+        if (m_fileName.empty() || m_width == 0 || m_height == 0 || m_data.empty())
+            return;
+
+        if (m_firstRow == 0)
+        {
+            discardChunks();
+            startFile();
+        }
+
+        if (m_firstRow != m_nextRow || !m_out.is_open())
+            return;
+
+        const int numRows = std::min(static_cast<int>(m_data.size() / m_width), m_height - m_firstRow);
+        std::shared_ptr<const std::vector<color_t>> band = std::make_shared<const std::vector<color_t>>(std::move(m_data));
+        m_data.clear();
+
+        // The rows are split into chunks that are encoded independently of each other. Only the filters need
+        // to look at the row above the chunk, which is handed to it alongside
+        const int rowsPerChunk = std::max(1, static_cast<int>(PNG_ChunkSize / (1 + PNG_BytesPerPixel * m_width)));
+        for (int row = 0; row < numRows; row += rowsPerChunk)
+        {
+            std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>();
+            chunk->band = band;
+            chunk->offset = static_cast<size_t>(row) * m_width;
+            chunk->numRows = std::min(rowsPerChunk, numRows - row);
+            if (row == 0)
+                chunk->previousRow = m_previousRow;
+            else
+                chunk->previousRow.assign(band->begin() + chunk->offset - m_width, band->begin() + chunk->offset);
+            chunk->first = m_firstRow + row == 0;
+            chunk->last = m_firstRow + row + chunk->numRows == m_height;
+            chunk->adler = 0;
+            chunk->length = 0;
+            chunk->done = false;
+
+            m_chunks.push_back(chunk);
+            m_threadPool.post([this, chunk, width = m_width, fast = m_fastCompression]() {
+                encode(*chunk, width, fast);
+                {
+                    std::lock_guard<std::mutex> lock{m_mutex};
+                    chunk->done = true;
+                }
+                m_cv.notify_all();
+            });
+        }
+
+        m_previousRow.assign(band->begin() + static_cast<size_t>(numRows - 1) * m_width,
+                             band->begin() + static_cast<size_t>(numRows) * m_width);
+        m_nextRow += numRows;
+
+        // Encoding carries on in the background while the next rows are rendered, unless too many chunks
+        // are pending already. The file is completed along with the last row.
+        if (m_nextRow < m_height)
+        {
+            writeChunks(4 * static_cast<size_t>(m_threadPool.getThreadCount()));
+            return;
+        }
+
+        writeChunks(0);
+
+        unsigned char trailer[4];
+        storeBigEndian(static_cast<uint32_t>(m_adler), trailer);
+        writeFileChunk("IDAT", trailer, sizeof(trailer));
+        writeFileChunk("IEND", nullptr, 0);
+        m_out.close();
+    }
+
+    void OutputDevicePNG::encode(Chunk &chunk, int width, bool fast)
+    {
+        const size_t rowLength = PNG_BytesPerPixel * width;
+        const size_t stride = 1 + rowLength;
+
+        std::vector<unsigned char> prev(rowLength, 0), cur(rowLength);
+        if (!chunk.previousRow.empty())
+            toRGB(chunk.previousRow.data(), width, prev.data());
+
+        // Each row is filtered with the filter leaving the smallest sum of absolute differences, which
+        // tends to deflate best
+        std::vector<unsigned char> filtered(stride * chunk.numRows);
+        std::vector<unsigned char> candidate(rowLength);
+        for (int row = 0; row < chunk.numRows; ++row)
+        {
+            toRGB(chunk.band->data() + chunk.offset + static_cast<size_t>(row) * width, width, cur.data());
+
+            unsigned char *out = filtered.data() + row * stride;
+            if (fast)
+            {
+                out[0] = PNG_FilterSub;
+                applyFilter(PNG_FilterSub, prev.data(), cur.data(), rowLength, out + 1);
+            }
+            else
+            {
+                uint64_t bestSum = UINT64_MAX;
+                for (int filter = PNG_FilterNone; filter < PNG_NumFilters; ++filter)
+                {
+                    applyFilter(static_cast<PngFilter>(filter), prev.data(), cur.data(), rowLength, candidate.data());
+
+                    uint64_t sum = 0;
+                    for (unsigned char byte : candidate)
+                        sum += byte < 128 ? byte : 256 - byte;
+
+                    if (sum < bestSum)
+                    {
+                        bestSum = sum;
+                        out[0] = static_cast<unsigned char>(filter);
+                        std::memcpy(out + 1, candidate.data(), rowLength);
+                    }
+                }
+            }
+
+            std::swap(prev, cur);
+        }
+
+        chunk.length = filtered.size();
+        chunk.adler = adler32(adler32(0L, Z_NULL, 0), filtered.data(), static_cast<uInt>(filtered.size()));
+
+        // Raw deflate streams can be joined as long as every one but the last ends on a byte boundary,
+        // which a sync flush ensures. The zlib header and trailer are written around the joined streams.
+        z_stream stream;
+        std::memset(&stream, 0, sizeof(stream));
+        deflateInit2(&stream, fast ? Z_BEST_SPEED : Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+
+        size_t used = 0;
+        if (chunk.first)
+        {
+            chunk.data = { 0x78, static_cast<unsigned char>(fast ? 0x01 : 0x9C) };
+            used = chunk.data.size();
+        }
+
+        stream.next_in = filtered.data();
+        stream.avail_in = static_cast<uInt>(filtered.size());
+
+        const int flushMode = chunk.last ? Z_FINISH : Z_SYNC_FLUSH;
+        int result = Z_OK;
+        do
+        {
+            chunk.data.resize(used + deflateBound(&stream, stream.avail_in) + 16);
+            stream.next_out = chunk.data.data() + used;
+            stream.avail_out = static_cast<uInt>(chunk.data.size() - used);
+
+            result = deflate(&stream, flushMode);
+            used = chunk.data.size() - stream.avail_out;
+        } while (result == Z_OK && (chunk.last || stream.avail_out == 0));
+
+        chunk.data.resize(used);
+        deflateEnd(&stream);
+    }
+
+    void OutputDevicePNG::writeChunks(size_t maxPending)
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        while (!m_chunks.empty())
+        {
+            std::shared_ptr<Chunk> chunk = m_chunks.front();
+            if (!chunk->done)
+            {
+                if (m_chunks.size() <= maxPending)
+                    break;
+
+                m_cv.wait(lock, [&chunk]() { return chunk->done; });
+            }
+            m_chunks.pop_front();
+
+            lock.unlock();
+            writeFileChunk("IDAT", chunk->data.data(), static_cast<uint32_t>(chunk->data.size()));
+            m_adler = adler32_combine(m_adler, chunk->adler, static_cast<z_off_t>(chunk->length));
+            lock.lock();
+        }
+    }
+
+    void OutputDevicePNG::discardChunks()
+    {
+        std::unique_lock<std::mutex> lock{m_mutex};
+        m_cv.wait(lock, [this]() {
+            return std::all_of(m_chunks.begin(), m_chunks.end(), [](const std::shared_ptr<Chunk> &chunk) { return chunk->done; });
+        });
+        m_chunks.clear();
+    }
+
+    void OutputDevicePNG::startFile()
+    {
+        if (m_out.is_open())
+            m_out.close();
+
+        m_nextRow = 0;
+        m_previousRow.clear();
+        m_adler = adler32(0L, Z_NULL, 0);
+
+        m_out.open(m_fileName, std::ios_base::binary | std::ios_base::trunc);
+        if (!m_out.is_open())
+            return;
+
+        static const unsigned char signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        m_out.write((const char*)signature, sizeof(signature));
+
+        // 8 bits per channel, RGB, no interlacing
+        unsigned char header[13] = { 0 };
+        storeBigEndian(static_cast<uint32_t>(m_width), header);
+        storeBigEndian(static_cast<uint32_t>(m_height), header + 4);
+        header[8] = 8;
+        header[9] = 2;
+        writeFileChunk("IHDR", header, sizeof(header));
+    }
+
+    void OutputDevicePNG::writeFileChunk(const char *type, const unsigned char *data, uint32_t length)
+    {
+        unsigned char field[4];
+        storeBigEndian(length, field);
+        m_out.write((const char*)field, sizeof(field));
+        m_out.write(type, 4);
+        if (length > 0)
+            m_out.write((const char*)data, length);
+
+        uLong crc = crc32(0L, Z_NULL, 0);
+        crc = crc32(crc, (const Bytef*)type, 4);
+        if (length > 0)
+            crc = crc32(crc, data, length);
+        storeBigEndian(static_cast<uint32_t>(crc), field);
+        m_out.write((const char*)field, sizeof(field));
+    }
+}
@@ -0,0 +1,129 @@
+#ifndef _MANDELBROT_LIB_OUTPUT_DEVICE_PNG_H_
+#define _MANDELBROT_LIB_OUTPUT_DEVICE_PNG_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "color/color.h"
+#include "output/output-device.h"
+#include "threading/thread-pool.h"
+
+namespace mandelbrot
+{
+
+/**
+ * @class OutputDevicePNG
+ * @brief Represents a handle to a PNG file, in which the output of a mandelbrot set calculation
+ *        will be written. Rows are encoded in the background as soon as they are flushed, split
+ *        into chunks which are filtered and deflated in parallel, independently of each other.
+ *        The deflate streams of the chunks are joined into a single zlib stream, so that the
+ *        encoding of one band of rows overlaps the rendering of the next.
+ *
+ *        Rows are expected to be flushed top to bottom, each once. Flushing the first row of the
+ *        image again starts the file over. The file is complete once the last row is flushed.
+ */
+class OutputDevicePNG final : public OutputDevice
+{
+public:
+    /// Constructs the device with the given number of encoding threads. If numThreads is not
+    /// positive, one thread is created per hardware thread of the processor
+    explicit OutputDevicePNG(int numThreads = 0);
+
+    /// Waits for the rows that are still being encoded
+    ~OutputDevicePNG();
+
+    void setFileName(const std::string &fileName);
+
+    /**
+     * @brief Trades file size for encoding speed. When enabled, every row is filtered with the
+     *        Sub filter and deflated at the fastest level, instead of picking the filter that
+     *        suits each row best and deflating at the default level.
+     */
+    void setFastCompression(bool enabled);
+
+    /**
+     * @brief Sets the dimensions of the file. Rows of a previous image that are still being encoded are discarded
+     * @param width Width of the file, in pixels
+     * @param height Height of the file, in pixels
+     */
+    void setDimensions(int32_t width, int32_t height) override;
+
+    void write(int xOffset, int yOffset, std::vector<color_t> &&data) override;
+
+    /// Hands the rows in memory over to the encoding threads
+    void flush() override;
+
+    /// Selects the rows held in memory until the next call to \ref flush()
+    void beginRows(int y, int height) override;
+
+    /// Returns the first pixel of a row held in memory
+    color_t *getRow(int y) override;
+
+private:
+    /// Rows of the image encoded as a single IDAT chunk of the file
+    struct Chunk;
+
+    /// Filters and deflates the rows of a chunk. Run on the encoding threads
+    static void encode(Chunk &chunk, int width, bool fast);
+
+    /// Writes the completed chunks at the front of \ref m_chunks to the file. Waits until no more than
+    /// maxPending chunks are left pending
+    void writeChunks(size_t maxPending);
+
+    /// Waits for every pending chunk, and discards them
+    void discardChunks();
+
+    /// Creates the file, and writes the signature and the header
+    void startFile();
+
+    /// Writes a chunk of the file with the given type and data
+    void writeFileChunk(const char *type, const unsigned char *data, uint32_t length);
+
+private:
+    std::string m_fileName;
+
+    bool m_fastCompression;
+
+    int32_t m_width;
+    int32_t m_height;
+
+    /// Pixels of the rows held in memory, starting at row \ref m_firstRow
+    std::vector<color_t> m_data;
+
+    /// Row of the image held first in \ref m_data
+    int32_t m_firstRow;
+
+    /// Row of the image expected to be flushed next
+    int32_t m_nextRow;
+
+    /// Last row handed over to the encoding threads, which the first row of the next chunk is filtered against
+    std::vector<color_t> m_previousRow;
+
+    /// File being written
+    std::ofstream m_out;
+
+    /// Checksum of the uncompressed data written to the file so far
+    unsigned long m_adler;
+
+    /// Mutex guarding the completion of the chunks
+    std::mutex m_mutex;
+
+    /// Condition variable, signalled when a chunk is completed
+    std::condition_variable m_cv;
+
+    /// Chunks handed over to the encoding threads, in the order they appear in the file
+    std::deque<std::shared_ptr<Chunk>> m_chunks;
+
+    /// Encoding threads. Destroyed first, so that the pending chunks are completed while the device is intact
+    ThreadPool m_threadPool;
+};
+
+}
+
+#endif // _MANDELBROT_LIB_OUTPUT_DEVICE_PNG_H_
@@ -1,10 +1,19 @@
 #include "output/output-device-qt.h"
 
-#include <cstring>
+#include <algorithm>
+#include <cstddef>
 #include <QColor>
 
 namespace mandelbrot
 {
+    OutputDeviceQt::OutputDeviceQt() :
+        m_width(0),
+        m_height(0),
+        m_image(),
+        m_pixels(nullptr)
+    {
+    }
+
     void OutputDeviceQt::setDimensions(int32_t width, int32_t height)
     {
         if (width <= 0 || height <= 0)
@@ -12,41 +21,39 @@ namespace mandelbrot
 
         m_width = width;
         m_height = height;
-        m_data.clear();
-        m_data.resize(m_width * m_height);
         m_image = QImage(width, height, QImage::Format_ARGB32);
+        m_pixels = nullptr;
     }
 
     void OutputDeviceQt::write(int xOffset, int yOffset, std::vector<color_t> &&data)
     {
-        const size_t pos = static_cast<size_t>((yOffset * m_width) + xOffset);
-        const size_t len = pos + data.size() >= m_data.size() ? m_data.size() - pos : data.size();
-        std::copy(data.begin(), data.begin() + len, m_data.begin() + pos);
-        /*
-        if ((yOffset * m_height) + xOffset + static_cast<int>(data.size()) > m_width * m_height)
+        if (yOffset < 0 || yOffset >= m_height || xOffset < 0 || xOffset >= m_width)
             return;
 
-        uint32_t *handle = ((uint32_t*)m_image.scanLine(yOffset)) + xOffset;
-
-        for (color_t pixel : data)
-        {
-            *handle++ = pixel.raw;
-        }*/
+        const size_t len = std::min(data.size(), static_cast<size_t>(m_width - xOffset));
+        std::copy(data.begin(), data.begin() + len, getRow(yOffset) + xOffset);
     }
 
     void OutputDeviceQt::flush()
     {
-        for (int32_t y = 0; y < m_height; ++y)
-        {
-            color_t *dataHandle = m_data.data() + (y * m_width);
-            uint32_t *handle = (uint32_t*)m_image.scanLine(y);
-            for (int32_t x = 0; x < m_width; ++x)
-                *handle++ = (dataHandle++)->raw;
-                //*handle++ = m_data.at((y * m_width) + x).raw;
-        }
-
-        //uint32_t *handle = (uint32_t*)m_image.scanLine(0);
-        //std::memcpy(handle, m_data.data(), m_data.size());
+        // Pixels have been written to the image directly, there is nothing left to copy. Copies of the image
+        // are handed out from here on, so the next frame has to detach from them first
+        m_pixels = nullptr;
+    }
+
+    void OutputDeviceQt::beginRows(int /*y*/, int /*height*/)
+    {
+        // Copies of the image share its pixels until one of them is modified. Detaching here, on a single
+        // thread, leaves the worker threads to write into pixels that no other image refers to.
+        m_pixels = m_image.bits();
+    }
+
+    color_t *OutputDeviceQt::getRow(int y)
+    {
+        if (!m_pixels)
+            beginRows(0, m_height);
+
+        return reinterpret_cast<color_t*>(m_pixels + static_cast<ptrdiff_t>(y) * m_image.bytesPerLine());
     }
 
     const QImage &OutputDeviceQt::getOutput() const
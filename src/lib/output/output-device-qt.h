@@ -14,22 +14,31 @@ namespace mandelbrot
 class OutputDeviceQt final : public OutputDevice
 {
 public:
+    OutputDeviceQt();
+
     void setDimensions(int32_t width, int32_t height) override;
 
     void write(int xOffset, int yOffset, std::vector<color_t> &&data) override;
 
     void flush() override;
 
+    /// Detaches the image from any copies handed out by \ref getOutput(), before its rows are written to
+    void beginRows(int y, int height) override;
+
+    /// Returns the first pixel of a scanline of the image
+    color_t *getRow(int y) override;
+
     const QImage &getOutput() const;
 
 private:
     int32_t m_width;
     int32_t m_height;
 
-    std::vector<color_t> m_data;
-
-    /// Output device, encapsulated by this class
+    /// Output device, encapsulated by this class. Pixels are written straight into its scanlines
     QImage m_image;
+
+    /// Pixels of \ref m_image, valid from \ref beginRows() onwards
+    uchar *m_pixels;
 };
 
 }
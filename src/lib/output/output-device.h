@@ -15,9 +15,27 @@ public:
     virtual void setDimensions(int32_t width, int32_t height) = 0;
     virtual void write(int xOffset, int yOffset, std::vector<color_t> &&data) = 0;
     virtual void flush() = 0;
+
+    /**
+     * @brief Prepares the device for the given rows of the frame to be written, up until the next call
+     *        to \ref flush(). Called before each frame (or pass, or band of a frame) on the thread that
+     *        calls \ref flush() afterwards. Devices may hold only these rows in memory.
+     * @param y First row to be written
+     * @param height Number of rows to be written
+     */
+    virtual void beginRows(int /*y*/, int /*height*/) {}
+
+    /**
+     * @brief Returns the first pixel of a row of the buffer the device outputs from, so that pixels
+     *        can be written in place rather than passed to \ref write(). Between \ref beginRows()
+     *        and \ref flush(), may be called from any thread, as long as no two threads write to
+     *        the same pixels.
+     * @param y Row of the frame
+     * @return Pointer to the row, or nullptr if the device does not give access to its rows
+     */
+    virtual color_t *getRow(int /*y*/) { return nullptr; }
 };
 
 }
 
 #endif // _MANDELBROT_LIB_OUTPUT_DEVICE_H_
-
@@ -0,0 +1,32 @@
+#ifndef _MANDELBROT_LIB_THREADING_CANCELLATION_TOKEN_H_
+#define _MANDELBROT_LIB_THREADING_CANCELLATION_TOKEN_H_
+
+#include <atomic>
+
+namespace mandelbrot
+{
+
+/**
+ * @class CancellationToken
+ * @brief Flag shared between the thread requesting a render and the threads performing it. Once
+ *        cancelled, the worker threads abandon the frame at the next opportunity.
+ */
+class CancellationToken
+{
+public:
+    /// Requests that the work observing this token is abandoned
+    void cancel() noexcept { m_cancelled.store(true, std::memory_order_relaxed); }
+
+    /// Clears the cancellation request, so the token can be used for another frame
+    void reset() noexcept { m_cancelled.store(false, std::memory_order_relaxed); }
+
+    /// Returns true if cancellation has been requested
+    bool isCancelled() const noexcept { return m_cancelled.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic_bool m_cancelled{false};
+};
+
+}
+
+#endif // _MANDELBROT_LIB_THREADING_CANCELLATION_TOKEN_H_
@@ -1,6 +1,8 @@
 #include "color/color-strategy-smooth.h"
 #include "color/color-strategy-iteration.h"
 #include "color/color-strategy-wavelength.h"
+#include "color/color-strategy-gradient.h"
+#include "color/color-strategy-histogram.h"
 #include "output/output-device-bmp.h"
 #include "output/output-device-qt.h"
 #include "threading/mandelbrot-thread-qt.h"
@@ -18,16 +20,24 @@ namespace mandelbrot
         m_mandelbrotSet(),
         m_renderAgain(false),
         m_quit(false),
-        m_discard(false),
+        m_cancellationToken(),
         m_maxIterations(0),
         m_outputWidth(0),
         m_outputHeight(0),
-        m_centerX(0.0),
-        m_centerY(0.0),
-        m_scale(0.0),
-        m_colorStrategy(nullptr)
+        m_centerX(),
+        m_centerY(),
+        m_scale(),
+        m_scrollX(0),
+        m_scrollY(0),
+        m_colorStrategy(nullptr),
+        m_renderStats()
     {
+        qRegisterMetaType<mandelbrot::FloatExp>("mandelbrot::FloatExp");
+
         m_mandelbrotSet.setOutputDevice(std::make_unique<OutputDeviceQt>());
+        // The status bar only shows the totals of each frame
+        m_mandelbrotSet.setStatsEnabled(true);
+        m_mandelbrotSet.setTileStatsEnabled(false);
     }
 
     MandelbrotThreadQt::~MandelbrotThreadQt()
@@ -63,15 +73,23 @@ namespace mandelbrot
             temp.setColorStrategy(std::make_unique<ColorStrategyIteration>());
         else if (colorStrategy == 2)
             temp.setColorStrategy(std::make_unique<ColorStrategyWavelength>());
+        else if (colorStrategy == 3)
+            temp.setColorStrategy(std::make_unique<ColorStrategyGradient>(Palette::fromName("classic")));
+        else if (colorStrategy == 4)
+            temp.setColorStrategy(std::make_unique<ColorStrategyHistogram>(Palette::fromName("classic")));
 
         temp.render();
     }
 
-    void MandelbrotThreadQt::createImage()
+    RenderStats MandelbrotThreadQt::getRenderStats() const
     {
         QMutexLocker lock{&m_mutex};
+        return m_renderStats;
+    }
 
-        m_discard.store(false);
+    void MandelbrotThreadQt::createImage()
+    {
+        QMutexLocker lock{&m_mutex};
 
         if (!isRunning())
         {
@@ -89,16 +107,25 @@ namespace mandelbrot
         if (!isRunning())
             return;
 
-        m_discard.store(true);
+        m_cancellationToken.cancel();
     }
 
-    void MandelbrotThreadQt::setCenter(double x, double y)
+    void MandelbrotThreadQt::setCenter(const PreciseReal &x, const PreciseReal &y)
     {
         QMutexLocker lock{&m_mutex};
         m_centerX = x;
         m_centerY = y;
     }
 
+    void MandelbrotThreadQt::scroll(int dx, int dy)
+    {
+        QMutexLocker lock{&m_mutex};
+        m_centerX.add(m_scale, dx);
+        m_centerY.add(m_scale, dy);
+        m_scrollX += dx;
+        m_scrollY += dy;
+    }
+
     void MandelbrotThreadQt::setColorStrategy(std::unique_ptr<ColorStrategy> colorStrategy)
     {
         QMutexLocker lock{&m_mutex};
@@ -118,7 +145,7 @@ namespace mandelbrot
         m_outputHeight = height;
     }
 
-    void MandelbrotThreadQt::setScale(double scale)
+    void MandelbrotThreadQt::setScale(const FloatExp &scale)
     {
         QMutexLocker lock{&m_mutex};
         m_scale = scale;
@@ -133,12 +160,25 @@ namespace mandelbrot
         while (!m_quit)
         {
             m_mutex.lock();
-            const double scale = m_scale;
+            const FloatExp scale = m_scale;
             m_mandelbrotSet.setMaxIterations(m_maxIterations);
-            m_mandelbrotSet.setCenter(m_centerX, m_centerY);
             m_mandelbrotSet.setScale(scale);
             m_mandelbrotSet.setOutputDimensions(m_outputWidth, m_outputHeight);
 
+            // Scrolling keeps the pixels that remain in view, if nothing else has changed. The center
+            // is set afterwards, which discards them again should it disagree with the scrolled center
+            if (m_scrollX != 0 || m_scrollY != 0)
+            {
+                m_mandelbrotSet.scroll(m_scrollX, m_scrollY);
+                m_scrollX = 0;
+                m_scrollY = 0;
+            }
+            m_mandelbrotSet.setCenter(m_centerX, m_centerY);
+
+            // Cancellation requests from before this point concern frames with older parameters
+            m_cancellationToken.reset();
+
+            const bool colorStrategyChanged = m_colorStrategy != nullptr;
             if (m_colorStrategy)
             {
                 m_mandelbrotSet.setColorStrategy(std::move(m_colorStrategy));
@@ -146,15 +186,26 @@ namespace mandelbrot
             }
             m_mutex.unlock();
 
-            m_mandelbrotSet.render();
+            auto emitOutput = [this, outDevice, scale]() {
+                if (!m_cancellationToken.isCancelled())
+                    emit outputReady(outDevice->getOutput(), scale);
+            };
 
-            if (!m_discard.load())
-                emit outputReady(outDevice->getOutput(), scale);
+            // A new color strategy only requires the last frame to be colored again, unless
+            // other parameters have changed as well. Otherwise, a coarse preview of the frame
+            // is shown as soon as it is available, and refined by the passes that follow.
+            if (colorStrategyChanged)
+            {
+                m_mandelbrotSet.recolor(&m_cancellationToken);
+                emitOutput();
+            }
             else
-                m_discard.store(false);
+                m_mandelbrotSet.renderProgressive(emitOutput, &m_cancellationToken);
 
             // after calculating the set,
             m_mutex.lock();
+            m_renderStats = m_mandelbrotSet.getRenderStats();
+            emit renderFinished();
             if (!m_renderAgain)
                 m_cv.wait(&m_mutex);
             m_renderAgain = false;
@@ -1,7 +1,6 @@
 #ifndef _MANDELBROT_LIB_MANDELBROT_THREAD_QT_H_
 #define _MANDELBROT_LIB_MANDELBROT_THREAD_QT_H_
 
-#include <atomic>
 #include <QImage>
 #include <QMutex>
 #include <QThread>
@@ -26,18 +25,31 @@ public:
     /// Saves the current mandelbrot image to a file with the given filename
     void saveToFile(const QString &fileName, int colorStrategy, double colorIntensity) const;
 
+    /// Returns the instrumentation of the last image that was completed, or cancelled
+    RenderStats getRenderStats() const;
+
     /// Renders the mandelbrot set with the current parameters
     void createImage();
 
-    /// Discards any images that are still being calculated/rendered
+    /// Cancels any image that is still being calculated/rendered. The worker threads abandon it
+    /// right away, so that the next call to \ref createImage() is served without delay
     void discardAny();
 
     /**
-     * @brief Sets the center coordinates on the Mandelbrot plane (not the output device)
+     * @brief Sets the center coordinates on the Mandelbrot plane (not the output device), as for
+     *        \ref MandelbrotSet::setCenter()
      * @param x Center position on the real portion of the plane (horizontal)
      * @param y Center position on the imaginary portion of the plane (vertical)
      */
-    void setCenter(double x, double y);
+    void setCenter(const PreciseReal &x, const PreciseReal &y);
+
+    /**
+     * @brief Moves the center of the set by the given number of pixels along each axis. Pixels of the
+     *        last image that remain in view are reused, see \ref MandelbrotSet::scroll()
+     * @param dx Number of pixels to move the center by along the real axis
+     * @param dy Number of pixels to move the center by along the imaginary axis
+     */
+    void scroll(int dx, int dy);
 
     /**
      * @brief Sets the coloring method to render items in and out of the mandelbrot
@@ -65,20 +77,24 @@ public:
      *        will be calculated
      * @param Scale factor. This should be a very small fractional value for good results.
      */
-    void setScale(double scale);
+    void setScale(const FloatExp &scale);
 
 protected:
-    /// Entry point in the worker thread. Invokes \ref MandelbrotSet::render() and emits
-    /// the outputReady signal with the contents of the \ref OutputDeviceQt
+    /// Entry point in the worker thread. Invokes \ref MandelbrotSet::renderProgressive(), or \ref MandelbrotSet::recolor()
+    /// if only the color strategy has changed, and emits the outputReady signal with the contents of the \ref OutputDeviceQt
+    /// after each pass
     void run() override;
 
 Q_SIGNALS:
-    /// Emitted when the mandelbrot image has finished rendering
-    void outputReady(const QImage &image, double scale);
+    /// Emitted when a pass of the mandelbrot image has finished rendering
+    void outputReady(const QImage &image, const mandelbrot::FloatExp &scale);
+
+    /// Emitted once every pass of an image has finished, or it has been cancelled. See \ref getRenderStats()
+    void renderFinished();
 
 private:
     /// Synchronization object
-    QMutex m_mutex;
+    mutable QMutex m_mutex;
 
     /// Condition variable
     QWaitCondition m_cv;
@@ -92,20 +108,30 @@ private:
     /// Flag indicating whether or not the thread needs to stop working
     bool m_quit;
 
-    /// Flag indicating whether or not the current image should be discarded
-    std::atomic_bool m_discard;
+    /// Cancels the image that is being rendered, when it should be discarded
+    CancellationToken m_cancellationToken;
 
     // Below parameters are queued for the run() routine
     int m_maxIterations;
     int m_outputWidth;
     int m_outputHeight;
-    double m_centerX;
-    double m_centerY;
-    double m_scale;
+    PreciseReal m_centerX;
+    PreciseReal m_centerY;
+    FloatExp m_scale;
+
+    /// Pixels the center has been moved by through \ref scroll() since the last image was started
+    int m_scrollX;
+    int m_scrollY;
 
     std::unique_ptr<ColorStrategy> m_colorStrategy;
+
+    /// Instrumentation of the last image, guarded by \ref m_mutex
+    RenderStats m_renderStats;
 };
 
 }
 
+// The scale is passed along with the images to the thread of the view
+Q_DECLARE_METATYPE(mandelbrot::FloatExp)
+
 #endif // _MANDELBROT_LIB_MANDELBROT_THREAD_QT_H_
@@ -1,57 +1,130 @@
+#include <algorithm>
+
 #include "threading/thread-pool.h"
 
 namespace mandelbrot
 {
 
+    /// Pool and queue index of the worker running on the current thread, if any
+    static thread_local ThreadPool *currentPool = nullptr;
+    static thread_local int currentQueue = -1;
+
     ThreadPool::ThreadPool(int numThreads) :
         m_mutex(),
         m_cv(),
         m_threads(),
-        m_tasks(),
+        m_queues(),
+        m_pendingTasks(0),
+        m_nextQueue(0),
         m_working(true)
     {
+        if (numThreads <= 0)
+            numThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+        m_queues.reserve(numThreads);
+        for (int i = 0; i < numThreads; ++i)
+            m_queues.push_back(std::make_unique<WorkQueue>());
+
         m_threads.reserve(numThreads);
         for (int i = 0; i < numThreads; ++i)
-            m_threads.emplace_back(std::bind(&ThreadPool::threadJob, this));
+            m_threads.emplace_back(std::bind(&ThreadPool::threadJob, this, i));
     }
 
     ThreadPool::~ThreadPool()
     {
-        m_working = false;
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_working = false;
+        }
         m_cv.notify_all();
 
         for (auto& thread : m_threads)
             thread.join();
     }
 
+    int ThreadPool::getThreadCount() const noexcept
+    {
+        return static_cast<int>(m_threads.size());
+    }
+
+    int ThreadPool::getCurrentThreadIndex() const noexcept
+    {
+        return currentPool == this ? currentQueue : -1;
+    }
+
     void ThreadPool::post(std::function<void()> &&work)
     {
-        std::lock_guard<std::mutex> lock{m_mutex};
-        m_tasks.push_back(std::move(work));
+        const int index = currentPool == this
+                ? currentQueue
+                : static_cast<int>(m_nextQueue++ % m_queues.size());
+
+        {
+            WorkQueue &queue = *m_queues[index];
+            std::lock_guard<std::mutex> lock{queue.mutex};
+            queue.tasks.push_back(std::move(work));
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            ++m_pendingTasks;
+        }
         m_cv.notify_one();
     }
 
-    void ThreadPool::threadJob()
+    void ThreadPool::threadJob(int index)
     {
+        currentPool = this;
+        currentQueue = index;
+
+        std::function<void()> task;
         while (true)
         {
+            if (takeTask(index, task))
+            {
+                task();
+                task = nullptr;
+                continue;
+            }
+
             std::unique_lock<std::mutex> lock{m_mutex};
             m_cv.wait(lock, [this](){
-                return !m_tasks.empty() || !m_working;
+                return m_pendingTasks > 0 || !m_working;
             });
 
-            if (!m_working && m_tasks.empty())
+            if (!m_working && m_pendingTasks == 0)
                 break;
+        }
+    }
 
-            std::function<void()> task = std::move(m_tasks.front());
-            m_tasks.pop_front();
-            lock.unlock();
-
-            task();
+    bool ThreadPool::takeTask(int index, std::function<void()> &task)
+    {
+        {
+            WorkQueue &queue = *m_queues[index];
+            std::lock_guard<std::mutex> lock{queue.mutex};
+            if (!queue.tasks.empty())
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                --m_pendingTasks;
+                return true;
+            }
+        }
 
-            if (!m_working && m_tasks.empty())
-                break;
+        const int numQueues = static_cast<int>(m_queues.size());
+        for (int i = 1; i < numQueues; ++i)
+        {
+            WorkQueue &victim = *m_queues[(index + i) % numQueues];
+            std::lock_guard<std::mutex> lock{victim.mutex};
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                --m_pendingTasks;
+                return true;
+            }
         }
+
+        return false;
     }
 
 }
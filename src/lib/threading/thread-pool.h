@@ -1,6 +1,7 @@
 #ifndef _MANDELBROT_LIB_THREADING_THREAD_POOL_H_
 #define _MANDELBROT_LIB_THREADING_THREAD_POOL_H_
 
+#include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <functional>
@@ -12,39 +13,110 @@
 namespace mandelbrot
 {
 
+/**
+ * @class ThreadPool
+ * @brief Work-stealing thread pool. Each worker thread owns a queue of tasks, which it works
+ *        through from the back. Once its own queue is empty, a worker steals tasks from the
+ *        front of the other queues, so that uneven workloads keep every thread busy.
+ */
 class ThreadPool
 {
 public:
-    /// Constructs the thread pool with a given number of worker threads
-    explicit ThreadPool(int numThreads);
+    /// Constructs the thread pool with a given number of worker threads. If numThreads is not
+    /// positive, one thread is created per hardware thread of the processor
+    explicit ThreadPool(int numThreads = 0);
 
-    /// Kills the thread pool
+    /// Kills the thread pool, after the pending tasks have been completed
     ~ThreadPool();
 
-    /// Posts a task to the end of the work queue
+    /// Returns the number of worker threads
+    int getThreadCount() const noexcept;
+
+    /// Returns the index of the worker thread of this pool that is calling it, or -1 if called from any other thread
+    int getCurrentThreadIndex() const noexcept;
+
+    /// Posts a task to the work queues. Tasks posted from a worker thread are placed on the
+    /// back of that worker's own queue, others are distributed among the queues in turn
     void post(std::function<void()> &&work);
 
 private:
-    /// Thread execution loop. Takes jobs from the queue to be performed
-    void threadJob();
+    /// Queue of tasks owned by a single worker thread
+    struct WorkQueue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    /// Thread execution loop. Takes jobs from the queues to be performed
+    void threadJob(int index);
+
+    /// Takes a task from the back of the worker's own queue, or failing that, from the front of another queue
+    bool takeTask(int index, std::function<void()> &task);
 
 private:
-    /// Mutex
+    /// Mutex guarding the sleeping state of the workers
     std::mutex m_mutex;
 
-    /// Condition variable
+    /// Condition variable, signalled when tasks are posted
     std::condition_variable m_cv;
 
     /// Worker threads
     std::vector<std::thread> m_threads;
 
-    /// Pending tasks
-    std::deque<std::function<void()>> m_tasks;
+    /// Pending tasks, one queue per worker thread
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+
+    /// Number of tasks waiting in the queues
+    std::atomic_int m_pendingTasks;
+
+    /// Queue that will receive the next task posted from outside of the pool
+    std::atomic_uint m_nextQueue;
 
     /// Worker flag - when set to false, the worker thread will halt
     bool m_working;
 };
 
+/**
+ * @class WorkerLocal
+ * @brief Holds one value of T for each worker thread of a pool, followed by one for the threads outside of it.
+ *        Each thread is handed its own value, so that the values are used without synchronization.
+ */
+template <typename T>
+class WorkerLocal
+{
+public:
+    /// Constructs a default value for each worker thread of the pool, and one for the other threads
+    explicit WorkerLocal(const ThreadPool &pool) :
+        m_pool(pool),
+        m_values()
+    {
+        for (int i = 0; i <= pool.getThreadCount(); ++i)
+            m_values.push_back(std::make_unique<T>());
+    }
+
+    /// Returns the value of the calling thread. Threads outside of the pool share a single value
+    T &local()
+    {
+        const int thread = m_pool.getCurrentThreadIndex();
+        return *m_values[thread < 0 ? m_pool.getThreadCount() : thread];
+    }
+
+    /// Calls the given function with every value, which must only be done while the pool is idle
+    template <typename Function>
+    void forEach(Function &&function)
+    {
+        for (const std::unique_ptr<T> &value : m_values)
+            function(*value);
+    }
+
+private:
+    /// Pool whose workers the values belong to
+    const ThreadPool &m_pool;
+
+    /// Value of each worker thread, in the order of their indices, followed by that of the other threads
+    std::vector<std::unique_ptr<T>> m_values;
+};
+
 }
 
 #endif // _MANDELBROT_LIB_THREADING_THREAD_POOL_H_
@@ -0,0 +1,273 @@
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <zlib.h>
+#include "tile-pyramid.h"
+
+namespace mandelbrot
+{
+    /// Default width and height of a tile, in pixels
+    static constexpr int DefaultPyramidTileSize = 256;
+
+    static uint32_t loadBigEndian(const unsigned char *in)
+    {
+        return (static_cast<uint32_t>(in[0]) << 24) | (static_cast<uint32_t>(in[1]) << 16)
+                | (static_cast<uint32_t>(in[2]) << 8) | static_cast<uint32_t>(in[3]);
+    }
+
+    TilePyramid::TilePyramid(MandelbrotSet &mandelbrotSet) :
+        m_mandelbrotSet(mandelbrotSet),
+        m_capture(nullptr),
+        m_writer(1),
+        m_directory(),
+        m_centerX(),
+        m_centerY(),
+        m_scale(),
+        m_maxLevel(0),
+        m_tileSize(DefaultPyramidTileSize),
+        m_onTileWritten(nullptr),
+        m_tilesWritten(0)
+    {
+    }
+
+    void TilePyramid::setDirectory(const std::string &directory)
+    {
+        m_directory = directory;
+    }
+
+    void TilePyramid::setRegion(const PreciseReal &centerX, const PreciseReal &centerY, const FloatExp &scale)
+    {
+        m_centerX = centerX;
+        m_centerY = centerY;
+        m_scale = scale;
+    }
+
+    void TilePyramid::setMaxLevel(int maxLevel)
+    {
+        if (maxLevel >= 0)
+            m_maxLevel = maxLevel;
+    }
+
+    void TilePyramid::setTileSize(int tileSize)
+    {
+        // Tiles are scaled down by averaging blocks of 2x2 pixels
+        if (tileSize > 0 && tileSize % 2 == 0)
+            m_tileSize = tileSize;
+    }
+
+    void TilePyramid::setFastCompression(bool enabled)
+    {
+        m_writer.setFastCompression(enabled);
+    }
+
+    int TilePyramid::generate(const std::function<void(int, int, int)> &onTileWritten)
+    {
+        if (m_directory.empty() || m_scale <= FloatExp())
+            return 0;
+
+        std::unique_ptr<OutputDeviceMemory> capture = std::make_unique<OutputDeviceMemory>();
+        m_capture = capture.get();
+        m_mandelbrotSet.setOutputDevice(std::move(capture));
+        m_mandelbrotSet.setOutputDimensions(m_tileSize, m_tileSize);
+        m_mandelbrotSet.setBandHeight(0);
+
+        m_onTileWritten = onTileWritten;
+        m_tilesWritten = 0;
+
+        // Tiles are generated depth first, so that only the tiles along a single path down the pyramid,
+        // and their children, are held in memory at once
+        std::vector<color_t> pixels;
+        buildTile(0, 0, 0, pixels);
+
+        m_onTileWritten = nullptr;
+        return m_tilesWritten;
+    }
+
+    void TilePyramid::buildTile(int level, int x, int y, std::vector<color_t> &pixels)
+    {
+        const std::string path = getTilePath(level, x, y);
+        if (std::filesystem::exists(path) && loadTile(path, pixels))
+            return;
+
+        if (level == m_maxLevel)
+        {
+            renderTile(level, x, y, pixels);
+        }
+        else
+        {
+            // Each child covers a quarter of the tile, and each of its 2x2 blocks of pixels is averaged into one
+            const int half = m_tileSize / 2;
+            pixels.resize(static_cast<size_t>(m_tileSize) * m_tileSize);
+            std::vector<color_t> child;
+            for (int childY = 0; childY < 2; ++childY)
+            {
+                for (int childX = 0; childX < 2; ++childX)
+                {
+                    buildTile(level + 1, 2 * x + childX, 2 * y + childY, child);
+
+                    for (int py = 0; py < half; ++py)
+                    {
+                        const color_t *row0 = child.data() + static_cast<size_t>(2 * py) * m_tileSize;
+                        const color_t *row1 = row0 + m_tileSize;
+                        color_t *out = pixels.data() + static_cast<size_t>(childY * half + py) * m_tileSize + childX * half;
+                        for (int px = 0; px < half; ++px)
+                        {
+                            const color_t *p0 = row0 + 2 * px;
+                            const color_t *p1 = row1 + 2 * px;
+                            color_t c;
+                            c.argb.r = static_cast<uint8_t>((p0[0].argb.r + p0[1].argb.r + p1[0].argb.r + p1[1].argb.r + 2) / 4);
+                            c.argb.g = static_cast<uint8_t>((p0[0].argb.g + p0[1].argb.g + p1[0].argb.g + p1[1].argb.g + 2) / 4);
+                            c.argb.b = static_cast<uint8_t>((p0[0].argb.b + p0[1].argb.b + p1[0].argb.b + p1[1].argb.b + 2) / 4);
+                            c.argb.a = 0xFF;
+                            out[px] = c;
+                        }
+                    }
+                }
+            }
+        }
+
+        saveTile(level, x, y, pixels);
+    }
+
+    void TilePyramid::renderTile(int level, int x, int y, std::vector<color_t> &pixels)
+    {
+        // The level is one image of (tileSize << level) pixels along each axis, of which the tile is a part
+        const FloatExp scale = m_scale * FloatExp(1.0, -level);
+        const double levelSize = std::ldexp(static_cast<double>(m_tileSize), level);
+        const double half = m_tileSize / 2.0;
+
+        PreciseReal centerX = m_centerX, centerY = m_centerY;
+        centerX.add(scale, x * static_cast<double>(m_tileSize) + half - levelSize / 2.0);
+        centerY.add(scale, y * static_cast<double>(m_tileSize) + half - levelSize / 2.0);
+
+        m_mandelbrotSet.setScale(scale);
+        m_mandelbrotSet.setCenter(centerX, centerY);
+        m_mandelbrotSet.render();
+
+        pixels = m_capture->getPixels();
+    }
+
+    std::string TilePyramid::getTilePath(int level, int x, int y) const
+    {
+        return m_directory + "/" + std::to_string(level) + "/" + std::to_string(x) + "/" + std::to_string(y) + ".png";
+    }
+
+    bool TilePyramid::loadTile(const std::string &path, std::vector<color_t> &pixels) const
+    {
+        std::ifstream in { path, std::ios_base::binary };
+        if (!in.is_open())
+            return false;
+
+        const std::vector<unsigned char> file { std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>() };
+        if (file.size() < 8 || std::memcmp(file.data(), "\x89PNG\r\n\x1A\n", 8) != 0)
+            return false;
+
+        // Only files as written by OutputDevicePNG are expected: 8-bit RGB, not interlaced
+        std::vector<unsigned char> compressed;
+        bool headerValid = false, complete = false;
+        for (size_t pos = 8; pos + 12 <= file.size() && !complete; )
+        {
+            const uint32_t length = loadBigEndian(file.data() + pos);
+            const char *type = reinterpret_cast<const char*>(file.data() + pos + 4);
+            const unsigned char *data = file.data() + pos + 8;
+            if (pos + 12 + length > file.size())
+                return false;
+
+            if (std::memcmp(type, "IHDR", 4) == 0)
+                headerValid = length == 13
+                        && loadBigEndian(data) == static_cast<uint32_t>(m_tileSize)
+                        && loadBigEndian(data + 4) == static_cast<uint32_t>(m_tileSize)
+                        && data[8] == 8 && data[9] == 2 && data[12] == 0;
+            else if (std::memcmp(type, "IDAT", 4) == 0)
+                compressed.insert(compressed.end(), data, data + length);
+            else if (std::memcmp(type, "IEND", 4) == 0)
+                complete = true;
+
+            pos += 12 + length;
+        }
+
+        if (!headerValid || !complete)
+            return false;
+
+        const size_t rowLength = 3 * static_cast<size_t>(m_tileSize);
+        const size_t stride = 1 + rowLength;
+        std::vector<unsigned char> filtered(stride * m_tileSize);
+        uLongf filteredSize = static_cast<uLongf>(filtered.size());
+        if (uncompress(filtered.data(), &filteredSize, compressed.data(), static_cast<uLong>(compressed.size())) != Z_OK
+                || filteredSize != filtered.size())
+            return false;
+
+        // Reverses the filter of each row, in place
+        pixels.resize(static_cast<size_t>(m_tileSize) * m_tileSize);
+        const unsigned char *prev = nullptr;
+        for (int y = 0; y < m_tileSize; ++y)
+        {
+            const unsigned char filter = filtered[y * stride];
+            unsigned char *row = filtered.data() + y * stride + 1;
+            for (size_t i = 0; i < rowLength; ++i)
+            {
+                const int a = i >= 3 ? row[i - 3] : 0;
+                const int b = prev ? prev[i] : 0;
+                const int c = prev && i >= 3 ? prev[i - 3] : 0;
+
+                int predictor = 0;
+                switch (filter)
+                {
+                case 0: break;
+                case 1: predictor = a; break;
+                case 2: predictor = b; break;
+                case 3: predictor = (a + b) / 2; break;
+                case 4:
+                {
+                    const int p = a + b - c;
+                    const int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+                    predictor = (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c);
+                    break;
+                }
+                default: return false;
+                }
+                row[i] = static_cast<unsigned char>(row[i] + predictor);
+            }
+
+            color_t *out = pixels.data() + static_cast<size_t>(y) * m_tileSize;
+            for (int x = 0; x < m_tileSize; ++x)
+            {
+                out[x].argb.r = row[3 * x];
+                out[x].argb.g = row[3 * x + 1];
+                out[x].argb.b = row[3 * x + 2];
+                out[x].argb.a = 0xFF;
+            }
+            prev = row;
+        }
+
+        return true;
+    }
+
+    void TilePyramid::saveTile(int level, int x, int y, const std::vector<color_t> &pixels)
+    {
+        const std::string path = getTilePath(level, x, y);
+        std::error_code error;
+        std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+        // The tile is written under a temporary name first, so that an interrupted run never leaves a partial
+        // tile behind under the name of a complete one
+        const std::string partialPath = path + ".part";
+        m_writer.setFileName(partialPath);
+        m_writer.setDimensions(m_tileSize, m_tileSize);
+        m_writer.beginRows(0, m_tileSize);
+        for (int row = 0; row < m_tileSize; ++row)
+            std::memcpy(m_writer.getRow(row), pixels.data() + static_cast<size_t>(row) * m_tileSize, m_tileSize * sizeof(color_t));
+        m_writer.flush();
+
+        std::filesystem::rename(partialPath, path, error);
+        if (error)
+            return;
+
+        ++m_tilesWritten;
+        if (m_onTileWritten)
+            m_onTileWritten(level, x, y);
+    }
+}
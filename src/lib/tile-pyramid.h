@@ -0,0 +1,107 @@
+#ifndef _MANDELBROT_LIB_TILE_PYRAMID_H_
+#define _MANDELBROT_LIB_TILE_PYRAMID_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "color/color.h"
+#include "mandelbrot.h"
+#include "output/output-device-memory.h"
+#include "output/output-device-png.h"
+
+namespace mandelbrot
+{
+
+/**
+ * @class TilePyramid
+ * @brief Renders a region of the plane as a pyramid of square PNG tiles, for zoomable maps. Level 0
+ *        is a single tile covering the region, and each level below it has twice as many tiles along
+ *        each axis as the one above. Tiles are written to <directory>/<level>/<x>/<y>.png.
+ *
+ *        Only the tiles of the deepest level are rendered. Each tile of a level above is the four tiles
+ *        below it, scaled down. Tiles that already exist are not generated again, so an interrupted
+ *        run picks up where it left off.
+ */
+class TilePyramid
+{
+public:
+    /// Constructs the pyramid, rendering its tiles with the given set. The color strategy, maximum number of
+    /// iterations and render strategy of the set are used as they are; its output device is replaced
+    explicit TilePyramid(MandelbrotSet &mandelbrotSet);
+
+    /// Sets the directory the tiles are written to
+    void setDirectory(const std::string &directory);
+
+    /**
+     * @brief Sets the region covered by the pyramid
+     * @param centerX Center of the region on the real portion of the plane
+     * @param centerY Center of the region on the imaginary portion of the plane
+     * @param scale Scale of the level 0 tile, as for \ref MandelbrotSet::setScale()
+     */
+    void setRegion(const PreciseReal &centerX, const PreciseReal &centerY, const FloatExp &scale);
+
+    /// Sets the deepest level of the pyramid, whose tiles are rendered
+    void setMaxLevel(int maxLevel);
+
+    /// Sets the width and height of a tile, in pixels. Defaults to 256
+    void setTileSize(int tileSize);
+
+    /// Trades file size for encoding speed, as for \ref OutputDevicePNG::setFastCompression()
+    void setFastCompression(bool enabled);
+
+    /**
+     * @brief Generates every missing tile of the pyramid
+     * @param onTileWritten Optional callback, invoked with the level and position of each tile written
+     * @return Number of tiles written
+     */
+    int generate(const std::function<void(int, int, int)> &onTileWritten = nullptr);
+
+private:
+    /// Fills pixels with the given tile, which is read from its file if it exists, and generated otherwise
+    void buildTile(int level, int x, int y, std::vector<color_t> &pixels);
+
+    /// Renders a tile of the deepest level
+    void renderTile(int level, int x, int y, std::vector<color_t> &pixels);
+
+    /// Returns the path of the file holding the given tile
+    std::string getTilePath(int level, int x, int y) const;
+
+    /// Reads a tile from a file written by \ref OutputDevicePNG. Returns false if it cannot be read
+    bool loadTile(const std::string &path, std::vector<color_t> &pixels) const;
+
+    /// Writes the given tile to its file
+    void saveTile(int level, int x, int y, const std::vector<color_t> &pixels);
+
+private:
+    MandelbrotSet &m_mandelbrotSet;
+
+    /// Output device of \ref m_mandelbrotSet, which rendered tiles are read from
+    OutputDeviceMemory *m_capture;
+
+    /// Encoder of the tile files
+    OutputDevicePNG m_writer;
+
+    std::string m_directory;
+
+    PreciseReal m_centerX;
+
+    PreciseReal m_centerY;
+
+    FloatExp m_scale;
+
+    int m_maxLevel;
+
+    int m_tileSize;
+
+    /// Callback of the current call to \ref generate()
+    std::function<void(int, int, int)> m_onTileWritten;
+
+    /// Number of tiles written by the current call to \ref generate()
+    int m_tilesWritten;
+};
+
+}
+
+#endif // _MANDELBROT_LIB_TILE_PYRAMID_H_
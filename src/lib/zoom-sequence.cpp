@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "zoom-sequence.h"
+
+namespace mandelbrot
+{
+    /// Returns true if the file name ends in the given extension
+    static bool hasExtension(const std::string &fileName, const char *extension)
+    {
+        const size_t length = std::strlen(extension);
+        return fileName.size() >= length && fileName.compare(fileName.size() - length, length, extension) == 0;
+    }
+
+    ZoomSequence::ZoomSequence(MandelbrotSet &mandelbrotSet) :
+        m_mandelbrotSet(mandelbrotSet),
+        m_pngWriter(),
+        m_bmpWriter(),
+        m_fileName(),
+        m_centerX(),
+        m_centerY(),
+        m_startScale(),
+        m_endScale(),
+        m_numFrames(0),
+        m_width(0),
+        m_height(0),
+        m_keyframeFactor(1.0),
+        m_pendingWrite()
+    {
+    }
+
+    ZoomSequence::~ZoomSequence()
+    {
+        if (m_pendingWrite.valid())
+            m_pendingWrite.wait();
+    }
+
+    void ZoomSequence::setFileName(const std::string &fileName)
+    {
+        m_fileName = fileName;
+    }
+
+    void ZoomSequence::setCenter(const PreciseReal &x, const PreciseReal &y)
+    {
+        m_centerX = x;
+        m_centerY = y;
+    }
+
+    void ZoomSequence::setScales(const FloatExp &startScale, const FloatExp &endScale)
+    {
+        m_startScale = startScale;
+        m_endScale = endScale;
+    }
+
+    void ZoomSequence::setFrameCount(int numFrames)
+    {
+        m_numFrames = numFrames;
+    }
+
+    void ZoomSequence::setFrameDimensions(int width, int height)
+    {
+        m_width = width;
+        m_height = height;
+    }
+
+    void ZoomSequence::setKeyframeFactor(double factor)
+    {
+        if (factor >= 1.0)
+            m_keyframeFactor = factor;
+    }
+
+    void ZoomSequence::setFastCompression(bool enabled)
+    {
+        m_pngWriter.setFastCompression(enabled);
+    }
+
+    int ZoomSequence::render(const std::function<void(int)> &onFrameWritten)
+    {
+        if (m_fileName.empty() || m_numFrames <= 0 || m_width <= 0 || m_height <= 0
+                || m_startScale <= FloatExp() || m_endScale <= FloatExp())
+            return 0;
+
+        std::unique_ptr<OutputDeviceMemory> capture = std::make_unique<OutputDeviceMemory>();
+        OutputDeviceMemory *image = capture.get();
+        m_mandelbrotSet.setOutputDevice(std::move(capture));
+        m_mandelbrotSet.setBandHeight(0);
+
+        // Every frame shares the center, and with it the reference orbit of deep zoom frames
+        m_mandelbrotSet.setCenter(m_centerX, m_centerY);
+
+        int numRendered = 0;
+        for (int first = 0; first < m_numFrames; )
+        {
+            // A group takes on frames for as long as its image, rendered at the smallest scale of the group,
+            // can cover the frame of the largest scale by being no more than the keyframe factor larger
+            FloatExp minScale = getFrameScale(first), maxScale = minScale;
+            int last = first;
+            while (last + 1 < m_numFrames)
+            {
+                const FloatExp scale = getFrameScale(last + 1);
+                if (std::max(maxScale, scale) > FloatExp(m_keyframeFactor) * std::min(minScale, scale))
+                    break;
+
+                minScale = std::min(minScale, scale);
+                maxScale = std::max(maxScale, scale);
+                ++last;
+            }
+
+            // The image is kept centered on the same pixel boundary as the frames, so that the frame of the
+            // smallest scale is cut out of it exactly
+            const double ratio = (maxScale / minScale).toDouble();
+            int width = static_cast<int>(std::ceil(m_width * ratio - 1e-9));
+            int height = static_cast<int>(std::ceil(m_height * ratio - 1e-9));
+            width += (width - m_width) % 2;
+            height += (height - m_height) % 2;
+            const Group group { first, last, minScale, width, height };
+
+            m_mandelbrotSet.setOutputDimensions(group.width, group.height);
+            m_mandelbrotSet.setScale(group.scale);
+            m_mandelbrotSet.render();
+            ++numRendered;
+
+            // The frames of the group are written while the next group is rendered
+            std::shared_ptr<const std::vector<color_t>> pixels = std::make_shared<const std::vector<color_t>>(image->getPixels());
+            if (m_pendingWrite.valid())
+                m_pendingWrite.get();
+            m_pendingWrite = std::async(std::launch::async, [this, group, pixels, onFrameWritten]() {
+                writeGroup(group, *pixels, onFrameWritten);
+            });
+
+            first = last + 1;
+        }
+
+        m_pendingWrite.get();
+        return numRendered;
+    }
+
+    FloatExp ZoomSequence::getFrameScale(int frame) const
+    {
+        if (m_numFrames <= 1)
+            return m_startScale;
+
+        // The ratio of the scales may be beyond the range of a double, and is raised to a power through its logarithm
+        return m_startScale * FloatExp::exp2((m_endScale / m_startScale).log2() * frame / (m_numFrames - 1));
+    }
+
+    std::string ZoomSequence::getFrameFileName(int frame) const
+    {
+        char number[16];
+        std::snprintf(number, sizeof(number), "-%05d", frame);
+
+        const size_t dot = m_fileName.find_last_of('.');
+        const size_t slash = m_fileName.find_last_of('/');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            return m_fileName + number;
+
+        return m_fileName.substr(0, dot) + number + m_fileName.substr(dot);
+    }
+
+    void ZoomSequence::writeGroup(const Group &group, const std::vector<color_t> &image, const std::function<void(int)> &onFrameWritten)
+    {
+        std::vector<color_t> frame;
+        for (int i = group.firstFrame; i <= group.lastFrame; ++i)
+        {
+            const FloatExp scale = getFrameScale(i);
+            if (scale == group.scale && group.width == m_width && group.height == m_height)
+                frame = image;
+            else
+                resample(group, image, scale, frame);
+
+            writeFrame(getFrameFileName(i), frame);
+
+            if (onFrameWritten)
+                onFrameWritten(i);
+        }
+    }
+
+    void ZoomSequence::resample(const Group &group, const std::vector<color_t> &image, const FloatExp &scale, std::vector<color_t> &frame) const
+    {
+        frame.resize(static_cast<size_t>(m_width) * m_height);
+
+        // Pixel x of the frame lies at position (x - width / 2) * ratio + imageWidth / 2 of the image. Each pixel
+        // is the average of four bilinear samples, spread over its footprint, which covers up to the keyframe
+        // factor pixels of the image along each axis.
+        const double ratio = (scale / group.scale).toDouble();
+
+        // The frame at the scale of the image is a part of it, as long as both are centered on a pixel boundary
+        if (ratio == 1.0 && (group.width - m_width) % 2 == 0 && (group.height - m_height) % 2 == 0)
+        {
+            const int left = (group.width - m_width) / 2, top = (group.height - m_height) / 2;
+            for (int y = 0; y < m_height; ++y)
+            {
+                const color_t *row = image.data() + static_cast<size_t>(top + y) * group.width + left;
+                std::copy(row, row + m_width, frame.data() + static_cast<size_t>(y) * m_width);
+            }
+            return;
+        }
+
+        const double maxX = group.width - 1, maxY = group.height - 1;
+        const double offsets[2] = { -0.25, 0.25 };
+
+        for (int y = 0; y < m_height; ++y)
+        {
+            color_t *out = frame.data() + static_cast<size_t>(y) * m_width;
+            for (int x = 0; x < m_width; ++x)
+            {
+                double r = 0.0, g = 0.0, b = 0.0;
+                for (double offsetY : offsets)
+                {
+                    const double v = std::clamp((y + offsetY - m_height / 2.0) * ratio + group.height / 2.0, 0.0, maxY);
+                    const int y0 = std::min(static_cast<int>(v), group.height - 1);
+                    const int y1 = std::min(y0 + 1, group.height - 1);
+                    const double fy = v - y0;
+
+                    for (double offsetX : offsets)
+                    {
+                        const double u = std::clamp((x + offsetX - m_width / 2.0) * ratio + group.width / 2.0, 0.0, maxX);
+                        const int x0 = std::min(static_cast<int>(u), group.width - 1);
+                        const int x1 = std::min(x0 + 1, group.width - 1);
+                        const double fx = u - x0;
+
+                        const color_t c00 = image[static_cast<size_t>(y0) * group.width + x0];
+                        const color_t c01 = image[static_cast<size_t>(y0) * group.width + x1];
+                        const color_t c10 = image[static_cast<size_t>(y1) * group.width + x0];
+                        const color_t c11 = image[static_cast<size_t>(y1) * group.width + x1];
+
+                        const double w00 = (1.0 - fx) * (1.0 - fy), w01 = fx * (1.0 - fy);
+                        const double w10 = (1.0 - fx) * fy, w11 = fx * fy;
+                        r += w00 * c00.argb.r + w01 * c01.argb.r + w10 * c10.argb.r + w11 * c11.argb.r;
+                        g += w00 * c00.argb.g + w01 * c01.argb.g + w10 * c10.argb.g + w11 * c11.argb.g;
+                        b += w00 * c00.argb.b + w01 * c01.argb.b + w10 * c10.argb.b + w11 * c11.argb.b;
+                    }
+                }
+
+                out[x].argb.r = static_cast<uint8_t>(r / 4.0 + 0.5);
+                out[x].argb.g = static_cast<uint8_t>(g / 4.0 + 0.5);
+                out[x].argb.b = static_cast<uint8_t>(b / 4.0 + 0.5);
+                out[x].argb.a = 0xFF;
+            }
+        }
+    }
+
+    void ZoomSequence::writeFrame(const std::string &fileName, const std::vector<color_t> &frame)
+    {
+        OutputDevice *writer = &m_bmpWriter;
+        if (hasExtension(fileName, ".png"))
+        {
+            m_pngWriter.setFileName(fileName);
+            writer = &m_pngWriter;
+        }
+        else
+        {
+            m_bmpWriter.setFileName(fileName);
+        }
+
+        writer->setDimensions(m_width, m_height);
+        writer->beginRows(0, m_height);
+        for (int y = 0; y < m_height; ++y)
+            std::memcpy(writer->getRow(y), frame.data() + static_cast<size_t>(y) * m_width, m_width * sizeof(color_t));
+        writer->flush();
+    }
+}
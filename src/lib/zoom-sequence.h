@@ -0,0 +1,134 @@
+#ifndef _MANDELBROT_LIB_ZOOM_SEQUENCE_H_
+#define _MANDELBROT_LIB_ZOOM_SEQUENCE_H_
+
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "color/color.h"
+#include "mandelbrot.h"
+#include "output/output-device-bmp.h"
+#include "output/output-device-memory.h"
+#include "output/output-device-png.h"
+
+namespace mandelbrot
+{
+
+/**
+ * @class ZoomSequence
+ * @brief Renders the frames of a zoom animation around a fixed center, with the scale changing
+ *        geometrically from one frame to the next. Frames are written to numbered BMP or PNG files,
+ *        chosen by the extension of the file name, while the next frames are being rendered.
+ *
+ *        Frames may be produced from keyframes instead of being rendered one by one: a keyframe is
+ *        rendered larger than the frames, and every frame it covers at no less than its own resolution
+ *        is resampled from it.
+ */
+class ZoomSequence
+{
+public:
+    /// Constructs the sequence, rendering its frames with the given set. The color strategy, maximum number of
+    /// iterations and render strategy of the set are used as they are; its output device is replaced
+    explicit ZoomSequence(MandelbrotSet &mandelbrotSet);
+
+    /// Waits for the frames that are still being written
+    ~ZoomSequence();
+
+    /// Sets the name of the files the frames are written to. The number of each frame is inserted before the extension
+    void setFileName(const std::string &fileName);
+
+    /// Sets the center of every frame, as for \ref MandelbrotSet::setCenter()
+    void setCenter(const PreciseReal &x, const PreciseReal &y);
+
+    /// Sets the scale of the first and last frames, as for \ref MandelbrotSet::setScale()
+    void setScales(const FloatExp &startScale, const FloatExp &endScale);
+
+    /// Sets the number of frames in the sequence
+    void setFrameCount(int numFrames);
+
+    /// Sets the dimensions of each frame, in pixels
+    void setFrameDimensions(int width, int height);
+
+    /**
+     * @brief Sets how much larger than a frame each keyframe is rendered, along each axis. A keyframe
+     *        of factor f serves every frame whose scale is between 1 and f times its own.
+     * @param factor Keyframe factor. Defaults to 1, which renders every frame on its own
+     */
+    void setKeyframeFactor(double factor);
+
+    /// Trades file size for encoding speed of PNG frames, as for \ref OutputDevicePNG::setFastCompression()
+    void setFastCompression(bool enabled);
+
+    /**
+     * @brief Renders and writes every frame of the sequence
+     * @param onFrameWritten Optional callback, invoked with the number of each frame once it has been written.
+     *        Invoked from a thread other than the caller's
+     * @return Number of frames rendered directly, or as keyframes
+     */
+    int render(const std::function<void(int)> &onFrameWritten = nullptr);
+
+private:
+    /// Frames produced from a single rendered image
+    struct Group
+    {
+        /// First and last frames of the group
+        int firstFrame;
+        int lastFrame;
+
+        /// Scale the image of the group is rendered at
+        FloatExp scale;
+
+        /// Dimensions of the image of the group
+        int width;
+        int height;
+    };
+
+    /// Returns the scale of the given frame
+    FloatExp getFrameScale(int frame) const;
+
+    /// Returns the name of the file the given frame is written to
+    std::string getFrameFileName(int frame) const;
+
+    /// Produces the frames of a group from its rendered image, and writes them to their files
+    void writeGroup(const Group &group, const std::vector<color_t> &image, const std::function<void(int)> &onFrameWritten);
+
+    /// Resamples a frame of the given scale from the image of a group
+    void resample(const Group &group, const std::vector<color_t> &image, const FloatExp &scale, std::vector<color_t> &frame) const;
+
+    /// Writes a frame to the given file
+    void writeFrame(const std::string &fileName, const std::vector<color_t> &frame);
+
+private:
+    MandelbrotSet &m_mandelbrotSet;
+
+    /// Encoders of the frame files
+    OutputDevicePNG m_pngWriter;
+    OutputDeviceBMP m_bmpWriter;
+
+    std::string m_fileName;
+
+    PreciseReal m_centerX;
+
+    PreciseReal m_centerY;
+
+    FloatExp m_startScale;
+
+    FloatExp m_endScale;
+
+    int m_numFrames;
+
+    int m_width;
+
+    int m_height;
+
+    double m_keyframeFactor;
+
+    /// Frames of the previous group, which are written while the next group is rendered
+    std::future<void> m_pendingWrite;
+};
+
+}
+
+#endif // _MANDELBROT_LIB_ZOOM_SEQUENCE_H_
@@ -3,6 +3,8 @@
 #include "color/color-strategy-smooth.h"
 #include "color/color-strategy-iteration.h"
 #include "color/color-strategy-wavelength.h"
+#include "color/color-strategy-gradient.h"
+#include "color/color-strategy-histogram.h"
 
 #include <cmath>
 
@@ -40,6 +42,7 @@ MandelbrotView::MandelbrotView(QWidget *parent) :
     m_thread.setScale(m_scale);
 
     connect(&m_thread, &mandelbrot::MandelbrotThreadQt::outputReady, this, &MandelbrotView::onImageCreated);
+    connect(&m_thread, &mandelbrot::MandelbrotThreadQt::renderFinished, this, &MandelbrotView::displayUpdated);
 }
 
 int MandelbrotView::getMaxIterations() const noexcept
@@ -52,21 +55,26 @@ double MandelbrotView::getColorIntensity() const noexcept
     return m_colorIntensity;
 }
 
-double MandelbrotView::getScale() const noexcept
+const mandelbrot::FloatExp &MandelbrotView::getScale() const noexcept
 {
     return m_scale;
 }
 
-double MandelbrotView::getCenterX() const noexcept
+const mandelbrot::PreciseReal &MandelbrotView::getCenterX() const noexcept
 {
     return m_centerX;
 }
 
-double MandelbrotView::getCenterY() const noexcept
+const mandelbrot::PreciseReal &MandelbrotView::getCenterY() const noexcept
 {
     return m_centerY;
 }
 
+mandelbrot::RenderStats MandelbrotView::getRenderStats() const
+{
+    return m_thread.getRenderStats();
+}
+
 void MandelbrotView::saveToFile(const QString &fileName, int colorStrategy)
 {
     if (!m_pixmap.save(fileName))
@@ -109,6 +117,24 @@ void MandelbrotView::setColorStrategyWave(bool enable)
     m_thread.createImage();
 }
 
+void MandelbrotView::setColorStrategyGradient(bool enable)
+{
+    if (!enable)
+        return;
+
+    m_thread.setColorStrategy(std::make_unique<mandelbrot::ColorStrategyGradient>(mandelbrot::Palette::fromName("classic")));
+    m_thread.createImage();
+}
+
+void MandelbrotView::setColorStrategyHistogram(bool enable)
+{
+    if (!enable)
+        return;
+
+    m_thread.setColorStrategy(std::make_unique<mandelbrot::ColorStrategyHistogram>(mandelbrot::Palette::fromName("classic")));
+    m_thread.createImage();
+}
+
 void MandelbrotView::setMaxIterations(int maxIterations)
 {
     if (maxIterations == m_maxIterations)
@@ -119,7 +145,7 @@ void MandelbrotView::setMaxIterations(int maxIterations)
     m_thread.createImage();
 }
 
-void MandelbrotView::setScale(double scale)
+void MandelbrotView::setScale(const mandelbrot::FloatExp &scale)
 {
     if (m_scale == scale)
         return;
@@ -131,7 +157,7 @@ void MandelbrotView::setScale(double scale)
     m_thread.createImage();
 }
 
-void MandelbrotView::onImageCreated(const QImage &image, double scale)
+void MandelbrotView::onImageCreated(const QImage &image, const mandelbrot::FloatExp &scale)
 {
     m_pixmap = QPixmap::fromImage(image);
     m_pixmapScale = scale;
@@ -143,11 +169,11 @@ void MandelbrotView::onImageCreated(const QImage &image, double scale)
 
 void MandelbrotView::scrollImage(int dx, int dy)
 {
-    m_centerX += dx * m_scale;
-    m_centerY += dy * m_scale;
+    m_centerX.add(m_scale, dx);
+    m_centerY.add(m_scale, dy);
     m_thread.discardAny();
     update();
-    m_thread.setCenter(m_centerX, m_centerY);
+    m_thread.scroll(dx, dy);
     m_thread.createImage();
 }
 
@@ -189,7 +215,7 @@ void MandelbrotView::paintEvent(QPaintEvent */*event*/)
 
     if (m_pixmapScale != m_scale)
     {
-        double zoomRatio = m_pixmapScale / m_scale;
+        double zoomRatio = (m_pixmapScale / m_scale).toDouble();
         int newWidth = static_cast<int>(m_pixmap.width() * zoomRatio);
         int newHeight = static_cast<int>(m_pixmap.height() * zoomRatio);
         int newX = m_dragOffset.x() + (m_pixmap.width() - newWidth) / 2;
@@ -217,6 +243,6 @@ void MandelbrotView::wheelEvent(QWheelEvent *event)
 {
     const QPoint degrees = event->angleDelta() / 8;
     const double numSteps = static_cast<double>(degrees.y()) / 15.0;
-    setScale(m_scale * std::pow(0.8, numSteps));
+    setScale(m_scale * mandelbrot::FloatExp(std::pow(0.8, numSteps)));
     event->accept();
 }
@@ -17,10 +17,13 @@ public:
 
     int getMaxIterations() const noexcept;
     double getColorIntensity() const noexcept;
-    double getScale() const noexcept;
+    const mandelbrot::FloatExp &getScale() const noexcept;
 
-    double getCenterX() const noexcept;
-    double getCenterY() const noexcept;
+    const mandelbrot::PreciseReal &getCenterX() const noexcept;
+    const mandelbrot::PreciseReal &getCenterY() const noexcept;
+
+    /// Returns the instrumentation of the last image rendered by the worker thread
+    mandelbrot::RenderStats getRenderStats() const;
 
 Q_SIGNALS:
     void displayUpdated();
@@ -29,10 +32,12 @@ public Q_SLOTS:
     void setColorStrategySmooth(bool enable);
     void setColorStrategyIter(bool enable);
     void setColorStrategyWave(bool enable);
+    void setColorStrategyGradient(bool enable);
+    void setColorStrategyHistogram(bool enable);
 
     void setMaxIterations(int maxIterations);
 
-    void setScale(double scale);
+    void setScale(const mandelbrot::FloatExp &scale);
 
     void setColorIntensity(double intensity);
 
@@ -40,7 +45,7 @@ public Q_SLOTS:
 
 private Q_SLOTS:
     /// Callback for when the latest image has been passed from the worker thread
-    void onImageCreated(const QImage &image, double scale);
+    void onImageCreated(const QImage &image, const mandelbrot::FloatExp &scale);
 
     /// Scrolls the mandelbrot image by the given delta. This updates the center X and Y coordinates on the plane
     void scrollImage(int dx, int dy);
@@ -78,16 +83,16 @@ private:
     QPoint m_dragOffset;
 
     /// Scale of the mandelbrot set on the pixmap (can be different than current scale)
-    double m_pixmapScale;
+    mandelbrot::FloatExp m_pixmapScale;
 
     /// Center x coordinate on the mandelbrot plane (the real axis)
-    double m_centerX;
+    mandelbrot::PreciseReal m_centerX;
 
     /// Center y coordinate on the mandelbrot plane (the imag axis)
-    double m_centerY;
+    mandelbrot::PreciseReal m_centerY;
 
     /// Scale of the fractal
-    double m_scale;
+    mandelbrot::FloatExp m_scale;
 
     /// Color intensity [only for smooth strategy]
     double m_colorIntensity;
@@ -23,6 +23,8 @@ Window::Window(QWidget *parent) :
     colorStrategyGroup->addAction(ui->actionSmooth);
     colorStrategyGroup->addAction(ui->actionPolynomial);
     colorStrategyGroup->addAction(ui->actionSin_Wave);
+    colorStrategyGroup->addAction(ui->actionGradient);
+    colorStrategyGroup->addAction(ui->actionHistogram);
     
     ui->actionSmooth->setChecked(true);
     colorStrategyGroup->setExclusive(true);
@@ -44,6 +46,8 @@ Window::Window(QWidget *parent) :
     connect(ui->actionSmooth,     &QAction::toggled, ui->mandelbrotWidget, &MandelbrotView::setColorStrategySmooth);
     connect(ui->actionPolynomial, &QAction::toggled, ui->mandelbrotWidget, &MandelbrotView::setColorStrategyIter);
     connect(ui->actionSin_Wave,   &QAction::toggled, ui->mandelbrotWidget, &MandelbrotView::setColorStrategyWave);
+    connect(ui->actionGradient,   &QAction::toggled, ui->mandelbrotWidget, &MandelbrotView::setColorStrategyGradient);
+    connect(ui->actionHistogram,  &QAction::toggled, ui->mandelbrotWidget, &MandelbrotView::setColorStrategyHistogram);
 
     connect(ui->actionIteration_Count, &QAction::triggered, this, &Window::openIterationDialog);
 
@@ -78,6 +82,10 @@ void Window::openSaveDialog()
             colorStrategy = 1;
         else if (ui->actionSin_Wave->isChecked())
             colorStrategy = 2;
+        else if (ui->actionGradient->isChecked())
+            colorStrategy = 3;
+        else if (ui->actionHistogram->isChecked())
+            colorStrategy = 4;
 
         ui->mandelbrotWidget->saveToFile(fileName, colorStrategy);
     }
@@ -112,9 +120,27 @@ void Window::setupSmoothColorSpecificAction()
 
 void Window::updateStatusBar()
 {
-    m_statusLabel->setText(QString("Iterations: %1 | Scale: %2 | Center: (%3, %4)")
+    static const char *pathNames[] = { "Direct", "Perturbation", "Precise" };
+    static const char *precisionNames[] = { "float", "double", "double-double", "MPFR" };
+
+    // Share of the time of the worker threads spent waiting for tiles
+    const mandelbrot::RenderStats stats = ui->mandelbrotWidget->getRenderStats();
+    double busySeconds = 0.0, idleSeconds = 0.0;
+    for (const mandelbrot::ThreadStats &thread : stats.threads)
+    {
+        busySeconds += thread.busySeconds;
+        idleSeconds += thread.idleSeconds;
+    }
+    const double idlePercent = busySeconds + idleSeconds > 0.0 ? 100.0 * idleSeconds / (busySeconds + idleSeconds) : 0.0;
+
+    m_statusLabel->setText(QString("Iterations: %1 | Scale: %2 | Center: (%3, %4) | %5 (%6): %7 ms, %8 M iterations, %9% idle")
         .arg(ui->mandelbrotWidget->getMaxIterations())
-        .arg(ui->mandelbrotWidget->getScale())
-        .arg(ui->mandelbrotWidget->getCenterX())
-        .arg(ui->mandelbrotWidget->getCenterY()));
+        .arg(QString::fromStdString(ui->mandelbrotWidget->getScale().toString(6)))
+        .arg(QString::fromStdString(ui->mandelbrotWidget->getCenterX().toString()))
+        .arg(QString::fromStdString(ui->mandelbrotWidget->getCenterY().toString()))
+        .arg(QLatin1String(pathNames[static_cast<int>(stats.path)]))
+        .arg(QLatin1String(precisionNames[static_cast<int>(stats.precision)]))
+        .arg(stats.totalSeconds * 1000.0, 0, 'f', 0)
+        .arg(stats.iterations / 1e6, 0, 'f', 1)
+        .arg(idlePercent, 0, 'f', 0));
 }